@@ -13,6 +13,8 @@
 #include <cmath>
 
 #include <ruby.h>
+#include <ruby/encoding.h>
+#include <ruby/version.h>
 
 // ruby.h has a few defines that conflict with Visual Studio's STL
 #if defined(_MSC_VER)
@@ -31,6 +33,19 @@
 // work on all platforms.  I'm not sure what to do about this.
 extern "C" typedef VALUE (*RUBY_VALUE_FUNC)(VALUE);
 
+// GC compaction was added in Ruby 2.7. Older versions never move objects.
+#if RUBY_API_VERSION_MAJOR == 2 && RUBY_API_VERSION_MINOR < 7
+inline void rb_gc_mark_movable(VALUE value)
+{
+  rb_gc_mark(value);
+}
+
+inline VALUE rb_gc_location(VALUE value)
+{
+  return value;
+}
+#endif
+
 // Fix Ruby RUBY_METHOD_FUNC from macro to typedef
 #if defined(RUBY_METHOD_FUNC)
 # undef RUBY_METHOD_FUNC
@@ -110,6 +125,16 @@ namespace Rice
     template<typename T>
     constexpr bool is_ostreamable_v = is_ostreamable<T>::value;
 
+    // Does the From_Ruby converter know how to check if a value is convertible? This is used to resolve overloads
+    template<typename T, typename = void>
+    struct has_is_convertible : std::false_type {};
+
+    template<typename T>
+    struct has_is_convertible<T, std::void_t<decltype(std::declval<T>().is_convertible(std::declval<VALUE>()))>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool has_is_convertible_v = has_is_convertible<T>::value;
+
     // Is the type comparable?
     template<typename T, typename SFINAE = void>
     struct is_comparable : std::false_type {};
@@ -409,6 +434,8 @@ namespace Rice
 // =========   RubyFunction.hpp   =========
 
 
+#include <optional>
+
 namespace Rice::detail
 {
   /* This is functor class that wraps calls to a Ruby C API method. It is needed because
@@ -428,18 +455,45 @@ namespace Rice::detail
     Return_T operator()();
 
   private:
+    // The result of the call is stored in the functor itself, which rb_protect passes
+    // through to the callback as its VALUE argument. Return values cannot be passed back
+    // as a VALUE because that is not lossless - for example a double with value of -1.0
+    // does not roundtrip. References are stored as pointers.
+    using Result_T = std::conditional_t<std::is_void_v<Return_T>, std::nullptr_t,
+                       std::conditional_t<std::is_reference_v<Return_T>, std::remove_reference_t<Return_T>*, Return_T>>;
+
     Function_T func_;
     std::tuple<Arg_Ts...> args_;
+    std::optional<Result_T> result_;
   };
 
   template<typename Function_T, typename ...Arg_Ts>
-  auto protect(Function_T func, Arg_Ts...args);
+  decltype(auto) protect(Function_T func, Arg_Ts...args);
+
+  /* Calls a Ruby C API function directly, without the setjmp and bookkeeping done by
+     protect. This is only safe for functions that cannot raise a Ruby exception (or
+     otherwise longjmp), because that would unwind through C++ frames without running
+     destructors. Functions that qualify include:
+
+       - Accessors that never allocate or check their arguments - rb_ary_entry,
+         rb_array_len, rb_class_of, rb_obj_class
+       - Type checks that are known to pass, such as rb_check_type on a value whose
+         type has already been checked
+
+     Note that functions which allocate Ruby objects, such as rb_str_new, can raise
+     NoMemoryError and thus should still be protected. That includes functions that only
+     allocate sometimes, such as rb_obj_classname for anonymous classes and rb_id2sym
+     for dynamic IDs. */
+  template<typename Function_T, typename ...Arg_Ts>
+  auto call_unprotected(Function_T func, Arg_Ts...args);
+
+  // Raises a TypeError if value is not a String. Only pays for protect when
+  // rb_check_type is going to raise an exception.
+  void checkString(VALUE value);
 }
 
 // ---------   RubyFunction.ipp   ---------
 
-#include <any>
-
 namespace Rice::detail
 {
   template<typename Function_T, typename...Arg_Ts>
@@ -454,28 +508,24 @@ namespace Rice::detail
     const int TAG_RAISE = 0x6; // From Ruby header files
     int state = 0;
 
-    // Setup a thread local variable to capture the result of the Ruby function call.
-    // We use thread_local because the lambda has to be captureless so it can
-    // be converted to a function pointer callable by C.
-    // The thread local variable avoids having to cast the result to VALUE and then 
-    // back again to Return_T. The problem with that is the translation is not lossless
-    // in some cases - for example a double with value of -1.0 does not roundrip.
-    // 
-    thread_local std::any result;
-
-    // Callback that will invoke the Ruby function
+    // Callback that will invoke the Ruby function. It has to be captureless so it can be
+    // converted to a function pointer callable by C, so the functor is passed as its argument.
     using Functor_T = RubyFunction<Function_T, Arg_Ts...>;
     auto callback = [](VALUE value) -> VALUE
     {
       Functor_T* functor = (Functor_T*)value;
 
-      if constexpr (std::is_same_v<Return_T, void>)
+      if constexpr (std::is_void_v<Return_T>)
       {
         std::apply(functor->func_, functor->args_);
       }
+      else if constexpr (std::is_reference_v<Return_T>)
+      {
+        functor->result_.emplace(&std::apply(functor->func_, functor->args_));
+      }
       else
       {
-        result = std::apply(functor->func_, functor->args_);
+        functor->result_.emplace(std::apply(functor->func_, functor->args_));
       }
 
       return Qnil;
@@ -489,7 +539,14 @@ namespace Rice::detail
     {
       if constexpr (!std::is_same_v<Return_T, void>)
       {
-        return std::any_cast<Return_T>(result);
+        if constexpr (std::is_reference_v<Return_T>)
+        {
+          return **this->result_;
+        }
+        else
+        {
+          return std::move(*this->result_);
+        }
       }
     }
     else
@@ -509,11 +566,25 @@ namespace Rice::detail
     
   // Create a functor for calling a Ruby function and define some aliases for readability.
   template<typename Function_T, typename ...Arg_Ts>
-  auto protect(Function_T func, Arg_Ts...args)
+  decltype(auto) protect(Function_T func, Arg_Ts...args)
   {
     auto rubyFunction = RubyFunction<Function_T, Arg_Ts...>(func, std::forward<Arg_Ts>(args)...);
     return rubyFunction();
   }
+
+  template<typename Function_T, typename ...Arg_Ts>
+  inline auto call_unprotected(Function_T func, Arg_Ts...args)
+  {
+    return func(args...);
+  }
+
+  inline void checkString(VALUE value)
+  {
+    if (rb_type(value) != RUBY_T_STRING)
+    {
+      detail::protect(rb_check_type, value, (int)T_STRING);
+    }
+  }
 }
 
 // Code for Ruby to call C++
@@ -797,10 +868,12 @@ namespace Rice::detail
 
 // =========   TypeRegistry.hpp   =========
 
+#include <iterator>
 #include <optional>
 #include <string>
 #include <typeindex>
 #include <typeinfo>
+#include <type_traits>
 #include <unordered_map>
 
 
@@ -832,8 +905,24 @@ namespace Rice::detail
     std::pair<VALUE, rb_data_type_t*> figureType(const T& object);
 
   private:
+    // Remembers the result of figureType for one C++ type so that returning an object
+    // does not probe registry_ every time. Entries are only valid for the registry and
+    // generation they were looked up in - add and remove bump the generation.
+    template <size_t N>
+    struct TypeCache
+    {
+      const TypeRegistry* registry = nullptr;
+      size_t generation = 0;
+      size_t next = 0;
+      const std::type_info* typeInfos[N] = {};
+      std::pair<VALUE, rb_data_type_t*> types[N] = {};
+    };
+
     std::optional<std::pair<VALUE, rb_data_type_t*>> lookup(const std::type_info& typeInfo);
+    std::pair<VALUE, rb_data_type_t*> resolve(const std::type_info& objectType, const std::type_info& staticType);
+
     std::unordered_map<std::type_index, std::pair<VALUE, rb_data_type_t*>> registry_{};
+    size_t generation_ = 1;
   };
 }
 
@@ -849,6 +938,7 @@ namespace Rice::detail
   {
     std::type_index key(typeid(T));
     registry_[key] = std::pair(klass, rbType);
+    this->generation_++;
   }
 
   template <typename T>
@@ -856,6 +946,7 @@ namespace Rice::detail
   {
     std::type_index key(typeid(T));
     registry_.erase(key);
+    this->generation_++;
   }
 
   template <typename T>
@@ -892,11 +983,10 @@ namespace Rice::detail
     }
   }
 
-  template <typename T>
-  inline std::pair<VALUE, rb_data_type_t*> TypeRegistry::figureType(const T& object)
+  inline std::pair<VALUE, rb_data_type_t*> TypeRegistry::resolve(const std::type_info& objectType, const std::type_info& staticType)
   {
     // First check and see if the actual type of the object is registered
-    std::optional<std::pair<VALUE, rb_data_type_t*>> result = lookup(typeid(object));
+    std::optional<std::pair<VALUE, rb_data_type_t*>> result = lookup(objectType);
 
     if (result)
     {
@@ -906,21 +996,69 @@ namespace Rice::detail
     // If not, then we are willing to accept an ancestor class specified by T. This is needed
     // to support Directors. Classes inherited from Directors are never actually registered
     // with Rice - and what we really want it to return the C++ class they inherit from.
-    result = lookup(typeid(T));
+    result = lookup(staticType);
     if (result)
     {
       return result.value();
     }
 
     // Give up!
-    std::string message = "Type " + typeName(typeid(object)) + " is not registered";
+    std::string message = "Type " + typeName(objectType) + " is not registered";
     throw std::runtime_error(message.c_str());
   }
+
+  template <typename T>
+  inline std::pair<VALUE, rb_data_type_t*> TypeRegistry::figureType(const T& object)
+  {
+    if constexpr (!std::is_polymorphic_v<T> || std::is_final_v<T>)
+    {
+      // The object's type has to be T so there is only one answer to remember
+      static TypeCache<1> cache;
+
+      if (cache.registry != this || cache.generation != this->generation_)
+      {
+        cache.types[0] = resolve(typeid(T), typeid(T));
+        cache.registry = this;
+        cache.generation = this->generation_;
+      }
+
+      return cache.types[0];
+    }
+    else
+    {
+      // The object could be any class derived from T. Remember the last few types seen,
+      // keyed on their type_info address. Distinct addresses can refer to the same type
+      // across shared libraries, which just costs an extra cache entry.
+      static TypeCache<4> cache;
+      const std::type_info& objectType = typeid(object);
+
+      if (cache.registry != this || cache.generation != this->generation_)
+      {
+        cache = TypeCache<4>();
+        cache.registry = this;
+        cache.generation = this->generation_;
+      }
+
+      for (size_t i = 0; i < std::size(cache.typeInfos); i++)
+      {
+        if (cache.typeInfos[i] == &objectType)
+        {
+          return cache.types[i];
+        }
+      }
+
+      std::pair<VALUE, rb_data_type_t*> result = resolve(objectType, typeid(T));
+      size_t slot = cache.next++ % std::size(cache.typeInfos);
+      cache.typeInfos[slot] = &objectType;
+      cache.types[slot] = result;
+      return result;
+    }
+  }
 }
 
 // =========   InstanceRegistry.hpp   =========
 
-#include <map>
+#include <vector>
 
 namespace Rice::detail
 {
@@ -928,77 +1066,225 @@ namespace Rice::detail
   {
   public:
     template <typename T>
-    VALUE lookup(T& cppInstance);
+    VALUE lookup(T& cppInstance, const rb_data_type_t* rbType);
 
     template <typename T>
-    VALUE lookup(T* cppInstance);
+    VALUE lookup(T* cppInstance, const rb_data_type_t* rbType);
 
     void add(void* cppInstance, VALUE rubyInstance);
     void remove(void* cppInstance);
     void clear();
 
+    // Updates the Ruby instance of cppInstance after GC compaction has moved it
+    void compact(void* cppInstance);
+
+    // Tracks instances of rbType, and types inherited from it, even if isEnabled is false
+    void track(const rb_data_type_t* rbType);
+    bool isTracked(const rb_data_type_t* rbType);
+
+    // Stops tracking rbType. Instances that are already tracked stay in the registry until
+    // they are freed.
+    void untrack(const rb_data_type_t* rbType);
+
   public:
     bool isEnabled = false;
 
   private:
-    VALUE lookup(void* cppInstance);
-    std::map<void*, VALUE> objectMap_;
+    // Open addressing hash table with linear probing. Empty slots have a nullptr key.
+    struct Entry
+    {
+      void* cppInstance = nullptr;
+      VALUE rubyInstance = Qnil;
+    };
+
+    VALUE lookup(void* cppInstance, const rb_data_type_t* rbType);
+    size_t slot(void* cppInstance) const;
+    void grow();
+
+    std::vector<Entry> entries_;
+    size_t size_ = 0;
+    std::vector<const rb_data_type_t*> trackedTypes_;
   };
 } // namespace Rice::detail
 
 
 // ---------   InstanceRegistry.ipp   ---------
-#include <memory>
+#include <algorithm>
+#include <cstdint>
 
 namespace Rice::detail
 {
   template <typename T>
-  inline VALUE InstanceRegistry::lookup(T& cppInstance)
+  inline VALUE InstanceRegistry::lookup(T& cppInstance, const rb_data_type_t* rbType)
   {
-    return this->lookup((void*)&cppInstance);
+    return this->lookup((void*)&cppInstance, rbType);
   }
 
   template <typename T>
-  inline VALUE InstanceRegistry::lookup(T* cppInstance)
+  inline VALUE InstanceRegistry::lookup(T* cppInstance, const rb_data_type_t* rbType)
   {
-    return this->lookup((void*)cppInstance);
+    return this->lookup((void*)cppInstance, rbType);
   }
 
-  inline VALUE InstanceRegistry::lookup(void* cppInstance)
+  inline VALUE InstanceRegistry::lookup(void* cppInstance, const rb_data_type_t* rbType)
   {
-    if (!this->isEnabled)
+    if (this->size_ == 0 || (!this->isEnabled && !this->isTracked(rbType)))
       return Qnil;
 
-    auto it = this->objectMap_.find(cppInstance);
-    if (it != this->objectMap_.end())
-    {
-      return it->second;
-    }
-    else
+    size_t mask = this->entries_.size() - 1;
+    for (size_t i = this->slot(cppInstance); this->entries_[i].cppInstance; i = (i + 1) & mask)
     {
-      return Qnil;
+      if (this->entries_[i].cppInstance == cppInstance)
+      {
+        return this->entries_[i].rubyInstance;
+      }
     }
+
+    return Qnil;
   }
 
   inline void InstanceRegistry::add(void* cppInstance, VALUE rubyInstance)
   {
-    if (this->isEnabled)
+    if (!cppInstance || (!this->isEnabled && !this->isTracked(RTYPEDDATA_TYPE(rubyInstance))))
+      return;
+
+    // Keep the table at most half full so probe sequences stay short
+    if ((this->size_ + 1) * 2 > this->entries_.size())
     {
-      this->objectMap_[cppInstance] = rubyInstance;
+      this->grow();
     }
+
+    size_t mask = this->entries_.size() - 1;
+    size_t i = this->slot(cppInstance);
+    while (this->entries_[i].cppInstance && this->entries_[i].cppInstance != cppInstance)
+    {
+      i = (i + 1) & mask;
+    }
+
+    if (!this->entries_[i].cppInstance)
+    {
+      this->entries_[i].cppInstance = cppInstance;
+      this->size_++;
+    }
+    this->entries_[i].rubyInstance = rubyInstance;
   }
 
   inline void InstanceRegistry::remove(void* cppInstance)
   {
-    this->objectMap_.erase(cppInstance);
+    // This is called every time a wrapper is freed, so return as quickly as possible
+    // when nothing is tracked. Checking size_ instead of isEnabled makes sure entries
+    // added before tracking was turned off are still removed.
+    if (this->size_ == 0)
+      return;
+
+    size_t mask = this->entries_.size() - 1;
+    size_t i = this->slot(cppInstance);
+    while (this->entries_[i].cppInstance != cppInstance)
+    {
+      if (!this->entries_[i].cppInstance)
+        return;
+      i = (i + 1) & mask;
+    }
+
+    // Shift following entries back into the hole so lookups never stop early. An entry can
+    // move unless its home slot lies cyclically between the hole and its current position.
+    for (size_t j = (i + 1) & mask; this->entries_[j].cppInstance; j = (j + 1) & mask)
+    {
+      size_t home = this->slot(this->entries_[j].cppInstance);
+      bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+      if (!stays)
+      {
+        this->entries_[i] = this->entries_[j];
+        i = j;
+      }
+    }
+
+    this->entries_[i] = Entry();
+    this->size_--;
   }
 
   inline void InstanceRegistry::clear()
   {
-    this->objectMap_.clear();
+    this->entries_.clear();
+    this->size_ = 0;
   }
-} // namespace
 
+  inline void InstanceRegistry::compact(void* cppInstance)
+  {
+    if (this->size_ == 0)
+      return;
+
+    size_t mask = this->entries_.size() - 1;
+    for (size_t i = this->slot(cppInstance); this->entries_[i].cppInstance; i = (i + 1) & mask)
+    {
+      if (this->entries_[i].cppInstance == cppInstance)
+      {
+        this->entries_[i].rubyInstance = rb_gc_location(this->entries_[i].rubyInstance);
+        return;
+      }
+    }
+  }
+
+  inline void InstanceRegistry::track(const rb_data_type_t* rbType)
+  {
+    if (!this->isTracked(rbType))
+    {
+      this->trackedTypes_.push_back(rbType);
+    }
+  }
+
+  inline void InstanceRegistry::untrack(const rb_data_type_t* rbType)
+  {
+    auto iter = std::find(this->trackedTypes_.begin(), this->trackedTypes_.end(), rbType);
+    if (iter != this->trackedTypes_.end())
+    {
+      this->trackedTypes_.erase(iter);
+    }
+  }
+
+  inline bool InstanceRegistry::isTracked(const rb_data_type_t* rbType)
+  {
+    for (; rbType && !this->trackedTypes_.empty(); rbType = rbType->parent)
+    {
+      if (std::find(this->trackedTypes_.begin(), this->trackedTypes_.end(), rbType) != this->trackedTypes_.end())
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  inline size_t InstanceRegistry::slot(void* cppInstance) const
+  {
+    // Objects are aligned so the low bits of their addresses are mostly zero. Fibonacci
+    // hashing spreads the remaining bits over the whole word.
+    std::uintptr_t hash = reinterpret_cast<std::uintptr_t>(cppInstance) * static_cast<std::uintptr_t>(0x9E3779B97F4A7C15ull);
+    hash ^= hash >> (sizeof(std::uintptr_t) * 4);
+    return static_cast<size_t>(hash) & (this->entries_.size() - 1);
+  }
+
+  inline void InstanceRegistry::grow()
+  {
+    std::vector<Entry> existing(std::max<size_t>(this->entries_.size() * 2, 16));
+    std::swap(existing, this->entries_);
+    this->size_ = 0;
+
+    size_t mask = this->entries_.size() - 1;
+    for (const Entry& entry : existing)
+    {
+      if (entry.cppInstance)
+      {
+        size_t i = this->slot(entry.cppInstance);
+        while (this->entries_[i].cppInstance)
+        {
+          i = (i + 1) & mask;
+        }
+        this->entries_[i] = entry;
+        this->size_++;
+      }
+    }
+  }
+} // namespace
 
 
 // =========   HandlerRegistry.hpp   =========
@@ -1071,35 +1357,93 @@ namespace Rice::detail
 
 
 
+// =========   Native.hpp   =========
+
+#include <typeinfo>
+
+
+namespace Rice::detail
+{
+  //! Base class of the objects Ruby calls into when it invokes a wrapped C++ function
+  /*! NativeFunction, NativeAttribute and NativeIterator all derive from Native. This
+   *  lets Rice keep pointers to them without knowing their template parameters, and
+   *  thus dispatch calls from Ruby to them through a single virtual function.
+   */
+  class Native
+  {
+  public:
+    Native() = default;
+    virtual ~Native() = default;
+
+    // Disallow copying/moving
+    Native(const Native&) = delete;
+    Native(Native&&) = delete;
+    void operator=(const Native&) = delete;
+    void operator=(Native&&) = delete;
+
+    // Invokes the wrapped C++ code with the arguments Ruby passed to the method
+    virtual VALUE operator()(int argc, VALUE* argv, VALUE self) = 0;
+
+    // Returns true if the arguments Ruby passed can be converted to the native's parameters.
+    // This is used to choose between natives overloaded under the same Ruby method.
+    virtual bool matches(int argc, VALUE* argv)
+    {
+      return true;
+    }
+
+    // Identifies the native's parameter types, or nullptr if the native cannot be overloaded.
+    // Natives with the same signature replace each other instead of being overloaded.
+    virtual const std::type_info* signature()
+    {
+      return nullptr;
+    }
+  };
+}
+
+
 // =========   NativeRegistry.hpp   =========
 
-#include <unordered_map>
-#include <any>
+#include <vector>
 
 
 namespace Rice::detail
 {
+  /* The NativeRegistry maps Ruby classes and method ids to the Native instances that
+     implement them. It is an open addressing hash table (with linear probing) that
+     is keyed on the full klass and method id pair so that two different methods can
+     never be confused with each other. */
   class NativeRegistry
   {
   public:
     // Add a new native callable object keyed by Ruby class and method_id
-    void add(VALUE klass, ID method_id, std::any callable);
+    void add(VALUE klass, ID method_id, Native* native);
+
+    // Returns the Native for the currently active Ruby method
+    Native* lookup();
+
+    // Returns the Native for the Ruby class and method_id or nullptr if there is none
+    Native* lookup(VALUE klass, ID method_id);
 
-    // Returns the Rice data for the currently active Ruby method
-    template <typename Return_T>
-    Return_T lookup();
+  private:
+    struct Entry
+    {
+      VALUE klass = 0;
+      ID method_id = 0;
+      Native* native = nullptr;
+    };
 
-    template <typename Return_T>
-    Return_T lookup(VALUE klass, ID method_id);
+    VALUE resolve(VALUE klass);
+    size_t hash(VALUE klass, ID method_id);
+    Entry& find(VALUE klass, ID method_id);
+    void grow();
 
   private:
-    size_t key(VALUE klass, ID method_id);
-    std::unordered_map<size_t, std::any> natives_ = {};
+    std::vector<Entry> entries_ = std::vector<Entry>(64);
+    size_t count_ = 0;
   };
 } 
 
 // ---------   NativeRegistry.ipp   ---------
-
 // Ruby 2.7 now includes a similarly named macro that uses templates to
 // pick the right overload for the underlying function. That doesn't work
 // for our cases because we are using this method dynamically and get a
@@ -1110,27 +1454,82 @@ namespace Rice::detail
 
 namespace Rice::detail
 {
-  // Effective Java (2nd edition)
-  // https://stackoverflow.com/a/2634715
-  inline size_t NativeRegistry::key(VALUE klass, ID id)
+  inline VALUE NativeRegistry::resolve(VALUE klass)
   {
+    // Methods defined in modules are invoked on the module's include class
     if (rb_type(klass) == T_ICLASS)
     {
-      klass = detail::protect(rb_class_of, klass);
+      klass = detail::call_unprotected(rb_class_of, klass);
     }
+    return klass;
+  }
+
+  inline size_t NativeRegistry::hash(VALUE klass, ID method_id)
+  {
+    // Mix both halves of the key (the finalizer from MurmurHash3) so that
+    // nearby classes and ids do not end up in nearby buckets
+    uint64_t result = (uint64_t)klass ^ ((uint64_t)method_id * 0x9e3779b97f4a7c15ULL);
+    result ^= result >> 33;
+    result *= 0xff51afd7ed558ccdULL;
+    result ^= result >> 33;
+    result *= 0xc4ceb9fe1a85ec53ULL;
+    result ^= result >> 33;
+    return (size_t)result;
+  }
+
+  inline NativeRegistry::Entry& NativeRegistry::find(VALUE klass, ID method_id)
+  {
+    // The table size is a power of two and is never full, so the probe
+    // will end at either the matching entry or an empty one
+    size_t mask = this->entries_.size() - 1;
+    size_t index = this->hash(klass, method_id) & mask;
+
+    while (true)
+    {
+      Entry& entry = this->entries_[index];
+      if (entry.native == nullptr || (entry.klass == klass && entry.method_id == method_id))
+      {
+        return entry;
+      }
+      index = (index + 1) & mask;
+    }
+  }
 
-    uint32_t prime = 53;
-    return (prime + klass) * prime + id;
+  inline void NativeRegistry::grow()
+  {
+    std::vector<Entry> entries(this->entries_.size() * 2);
+    std::swap(this->entries_, entries);
+
+    for (const Entry& entry : entries)
+    {
+      if (entry.native)
+      {
+        this->find(entry.klass, entry.method_id) = entry;
+      }
+    }
   }
 
-  inline void NativeRegistry::add(VALUE klass, ID method_id, std::any callable)
+  inline void NativeRegistry::add(VALUE klass, ID method_id, Native* native)
   {
-    // Now store data about it
-    this->natives_[key(klass, method_id)] = callable;
+    // Keep the load factor under 50% so probes stay short
+    if ((this->count_ + 1) * 2 > this->entries_.size())
+    {
+      this->grow();
+    }
+
+    klass = this->resolve(klass);
+    Entry& entry = this->find(klass, method_id);
+    if (entry.native == nullptr)
+    {
+      this->count_++;
+    }
+
+    entry.klass = klass;
+    entry.method_id = method_id;
+    entry.native = native;
   }
 
-  template <typename Return_T>
-  inline Return_T NativeRegistry::lookup()
+  inline Native* NativeRegistry::lookup()
   {
     ID method_id;
     VALUE klass;
@@ -1139,20 +1538,19 @@ namespace Rice::detail
       rb_raise(rb_eRuntimeError, "Cannot get method id and class for function");
     }
 
-    return this->lookup<Return_T>(klass, method_id);
-  }
-
-  template <typename Return_T>
-  inline Return_T NativeRegistry::lookup(VALUE klass, ID method_id)
-  {
-    auto iter = this->natives_.find(key(klass, method_id));
-    if (iter == this->natives_.end())
+    Native* native = this->lookup(klass, method_id);
+    if (native == nullptr)
     {
       rb_raise(rb_eRuntimeError, "Could not find data for klass and method id");
     }
 
-    std::any data = iter->second;
-    return std::any_cast<Return_T>(data);
+    return native;
+  }
+
+  inline Native* NativeRegistry::lookup(VALUE klass, ID method_id)
+  {
+    klass = this->resolve(klass);
+    return this->find(klass, method_id).native;
   }
 }
 
@@ -1301,79 +1699,402 @@ namespace Rice::detail
   }
 }
 
-// =========   Wrapper.hpp   =========
+// =========   NativeSlots.hpp   =========
 
+#include <array>
+#include <utility>
 
-namespace Rice
-{
-namespace detail
-{
 
-class Wrapper
-{
-public:
-  virtual ~Wrapper() = default;
-  virtual void* get() = 0;
+// The number of Ruby methods that can be dispatched directly to their Native. Methods
+// defined after all the slots are claimed fall back to a NativeRegistry lookup. Each slot
+// adds one trampoline per arity used to every translation unit, so larger values make
+// compiling and linking noticeably slower.
+#ifndef RICE_NATIVE_SLOTS
+#define RICE_NATIVE_SLOTS 128
+#endif
 
-  void ruby_mark();
-  void addKeepAlive(VALUE value);
+namespace Rice::detail
+{
+  /* The Ruby C API does not provide a way to associate data with a method. Thus when Ruby
+     calls a C function it has no way to tell the function which Native to invoke, and the
+     function instead has to look up the current method's class and id and then find the
+     Native in the NativeRegistry.
+
+     NativeSlots avoids that lookup. It generates a pool of trampoline functions at compile
+     time, one per slot, and each trampoline calls the Native stored in its slot. Binding a
+     Native to a Ruby method claims a free slot and registers that slot's trampoline with Ruby,
+     so calling the method costs an array load plus a virtual call. Once all the slots are
+     claimed, methods are bound to an extra trampoline that looks up the Native in the
+     NativeRegistry instead. Slots are never reused. Redefining a method claims a new slot
+     and the old slot keeps its Native, so aliases of the old method still call it with the
+     arity its trampoline was built for.
+
+     Trampolines are generated for both variable (-1) and fixed (0 to 15) arities so they can
+     match the signature Ruby expects for the method. */
+  class NativeSlots
+  {
+  public:
+    //! Registers native for klass and method_id, claims a slot for it and returns the
+    //! trampoline Ruby should call for it
+    template<int Arity>
+    static RUBY_METHOD_FUNC claim(VALUE klass, ID method_id, Native* native);
 
-private:
-  // We use a vector for speed and memory locality versus a set which does
-  // not scale well when getting to tens of thousands of objects (not expecting
-  // that to happen...but just in case)
-  std::vector<VALUE> keepAlive_;
-};
+  private:
+    template<std::size_t>
+    using Value_T = VALUE;
 
-template <typename T, typename Wrapper_T = void>
-VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T& data, bool isOwner);
+    // Calls native and translates any C++ exceptions into Ruby exceptions. Keeping this out
+    // of the trampolines keeps them tiny, which matters since there are so many of them.
+    static VALUE invoke(Native* native, int argc, VALUE* argv, VALUE self);
 
-template <typename T, typename Wrapper_T = void>
-VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T* data, bool isOwner);
+    // Returns the Native in a slot. The slot after the last one is not backed by the
+    // slots array and instead looks up the Native in the NativeRegistry.
+    template<std::size_t Slot>
+    static Native* native();
 
-template <typename T>
-T* unwrap(VALUE value, rb_data_type_t* rb_type);
+    // Trampoline for methods with variable arity
+    template<std::size_t Slot>
+    static VALUE call(int argc, VALUE* argv, VALUE self);
 
-Wrapper* getWrapper(VALUE value, rb_data_type_t* rb_type);
+    // Trampoline for methods with fixed arity
+    template<std::size_t Slot, std::size_t...I>
+    static VALUE callFixed(VALUE self, Value_T<I>...values);
 
-template <typename T>
-void replace(VALUE value, rb_data_type_t* rb_type, T* data, bool isOwner);
+    template<int Arity, std::size_t Slot>
+    static RUBY_METHOD_FUNC makeTrampoline();
 
-Wrapper* getWrapper(VALUE value);
+    template<std::size_t Slot, std::size_t...I>
+    static RUBY_METHOD_FUNC makeTrampolineFixed(std::index_sequence<I...>& indices);
 
-} // namespace detail
-} // namespace Rice
+    template<int Arity, std::size_t...Slot>
+    static RUBY_METHOD_FUNC trampoline(std::size_t slot, std::index_sequence<Slot...>& slots);
 
+  private:
+    static inline std::array<Native*, RICE_NATIVE_SLOTS> natives_{};
+    static inline std::size_t count_ = 0;
+  };
+}
 
-// ---------   Wrapper.ipp   ---------
-#include <memory>
+// ---------   NativeSlots.ipp   ---------
 
 namespace Rice::detail
 {
-  inline void Wrapper::ruby_mark()
+  template<int Arity>
+  inline RUBY_METHOD_FUNC NativeSlots::claim(VALUE klass, ID method_id, Native* native)
   {
-    for (VALUE value : this->keepAlive_)
+    static_assert(Arity >= -1 && Arity <= 15, "Ruby methods must have an arity between -1 and 15");
+
+    // If all slots are claimed use the extra slot that looks up natives in the registry
+    std::size_t slot = RICE_NATIVE_SLOTS;
+
+    if (count_ < natives_.size())
     {
-      rb_gc_mark(value);
+      slot = count_++;
+      natives_[slot] = native;
     }
+
+    Registries::instance.natives.add(klass, method_id, native);
+
+    auto slots = std::make_index_sequence<RICE_NATIVE_SLOTS + 1>{};
+    return trampoline<Arity>(slot, slots);
   }
 
-  inline void Wrapper::addKeepAlive(VALUE value)
+  template<std::size_t Slot>
+  inline Native* NativeSlots::native()
   {
-    this->keepAlive_.push_back(value);
+    if constexpr (Slot < RICE_NATIVE_SLOTS)
+    {
+      return natives_[Slot];
+    }
+    else
+    {
+      return Registries::instance.natives.lookup();
+    }
+  }
+
+  inline VALUE NativeSlots::invoke(Native* native, int argc, VALUE* argv, VALUE self)
+  {
+    return cpp_protect([&]
+    {
+      return native->operator()(argc, argv, self);
+    });
+  }
+
+  template<std::size_t Slot>
+  inline VALUE NativeSlots::call(int argc, VALUE* argv, VALUE self)
+  {
+    return invoke(native<Slot>(), argc, argv, self);
+  }
+
+  template<std::size_t Slot, std::size_t...I>
+  inline VALUE NativeSlots::callFixed(VALUE self, Value_T<I>...values)
+  {
+    std::array<VALUE, sizeof...(I)> argv = { values... };
+    return invoke(native<Slot>(), (int)argv.size(), argv.data(), self);
+  }
+
+  template<int Arity, std::size_t Slot>
+  inline RUBY_METHOD_FUNC NativeSlots::makeTrampoline()
+  {
+    if constexpr (Arity < 0)
+    {
+      return (RUBY_METHOD_FUNC)&NativeSlots::call<Slot>;
+    }
+    else
+    {
+      auto indices = std::make_index_sequence<Arity>{};
+      return makeTrampolineFixed<Slot>(indices);
+    }
+  }
+
+  template<std::size_t Slot, std::size_t...I>
+  inline RUBY_METHOD_FUNC NativeSlots::makeTrampolineFixed(std::index_sequence<I...>& indices)
+  {
+    return (RUBY_METHOD_FUNC)&NativeSlots::callFixed<Slot, I...>;
+  }
+
+  template<int Arity, std::size_t...Slot>
+  inline RUBY_METHOD_FUNC NativeSlots::trampoline(std::size_t slot, std::index_sequence<Slot...>& slots)
+  {
+    // One trampoline per slot, only generated for the arities that are actually used
+    static const RUBY_METHOD_FUNC trampolines[] = { makeTrampoline<Arity, Slot>()... };
+    return trampolines[slot];
+  }
+}
+
+
+// =========   ruby_memsize.hpp   =========
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Rice::detail
+{
+  // Memory a T owns outside of the object itself, such as the buffer of a std::vector.
+  // The STL support in stl.hpp specializes this for the containers it wraps.
+  template<typename T>
+  struct HeapSize
+  {
+    static size_t size(const T& data)
+    {
+      return 0;
+    }
+  };
+}
+
+namespace Rice
+{
+  //! Default function to call to calculate the memory used by a data object.
+  /*! This is what ObjectSpace.memsize_of reports for wrapped objects. The
+   *  default is sizeof(T) plus the heap memory of the STL containers that
+   *  Rice supports. It can be specialized for a particular type to include
+   *  other memory that the object owns.
+   */
+  template<typename T>
+  size_t ruby_memsize(const T* data)
+  {
+    return sizeof(T) + detail::HeapSize<T>::size(*data);
+  }
+
+  //! Whether Ruby is told about the memory used by wrapped objects of type T.
+  /*! Ruby triggers garbage collections based on how much memory has been
+   *  allocated, but it does not see allocations made by C++ code. Specialize
+   *  this to std::true_type and Rice will report ruby_memsize with
+   *  rb_gc_adjust_memory_usage when a Ruby owned T is created and freed.
+   */
+  template<typename T>
+  struct ruby_adjust_memory_usage : std::false_type
+  {
+  };
+}
+
+namespace Rice::detail
+{
+  // Heap memory owned by an element of a container, including memory reported by a
+  // custom ruby_memsize. Scalars never own memory so containers can skip visiting them.
+  template<typename T>
+  size_t elementHeapSize(const T& data)
+  {
+    if constexpr (std::is_scalar_v<T>)
+    {
+      return 0;
+    }
+    else
+    {
+      // A custom ruby_memsize may report less than sizeof(T)
+      size_t size = ruby_memsize<T>(&data);
+      return size > sizeof(T) ? size - sizeof(T) : 0;
+    }
   }
+}
+
+// =========   Wrapper.hpp   =========
+
+
+namespace Rice
+{
+namespace detail
+{
+
+class Wrapper
+{
+public:
+  virtual ~Wrapper() = default;
+  virtual void* get() = 0;
+
+  // Updates references to Ruby objects after GC compaction has moved them
+  virtual void ruby_compact();
+
+  void ruby_mark();
+  // Keeps value alive as long as owner, the Ruby object of this wrapper, is alive
+  void addKeepAlive(VALUE owner, VALUE value);
+
+private:
+  // We use a vector for speed and memory locality versus a set which does
+  // not scale well when getting to tens of thousands of objects (not expecting
+  // that to happen...but just in case)
+  std::vector<VALUE> keepAlive_;
+};
+
+template <typename T>
+class WrapperValue;
+
+template <typename T, typename Wrapper_T = void>
+VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T& data, bool isOwner);
+
+template <typename T, typename Wrapper_T = void>
+VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T* data, bool isOwner);
+
+template <typename T>
+T* unwrap(VALUE value, rb_data_type_t* rb_type);
+
+Wrapper* getWrapper(VALUE value, rb_data_type_t* rb_type);
+
+// Checks if value wraps an object of rb_type or of a type that inherits from it. Unlike
+// rb_check_typeddata this never raises and thus does not need to be protected.
+bool isTypedData(VALUE value, const rb_data_type_t* rb_type);
+
+// Data_Type stores the address of this tag in the data field of every rb_data_type_t it
+// creates, so that objects wrapped by Rice can be told apart from other T_DATA objects
+inline char wrappedTypeTag = 0;
+
+// Checks if value is an object wrapped by Rice
+bool isWrapped(VALUE value);
+
+template <typename T>
+void replace(VALUE value, rb_data_type_t* rb_type, T* data, bool isOwner);
+
+// Constructs a T owned by value. The object is stored inside its wrapper so creating it
+// takes a single allocation.
+template <typename T, typename Wrapper_T = WrapperValue<T>, typename...Arg_Ts>
+T* emplace(VALUE value, rb_data_type_t* rb_type, Arg_Ts&&...args);
+
+Wrapper* getWrapper(VALUE value);
+
+} // namespace detail
+} // namespace Rice
+
+
+// ---------   Wrapper.ipp   ---------
+#include <memory>
+#include <utility>
+
+namespace Rice::detail
+{
+  inline void Wrapper::ruby_mark()
+  {
+    for (VALUE value : this->keepAlive_)
+    {
+      // C++ code holds on to the data of wrapped objects, not their Ruby objects, so those
+      // can be moved by compaction. Any other value may have been stored by C++ code as a
+      // VALUE, which compaction cannot update, and thus is pinned.
+      if (isWrapped(value))
+      {
+        rb_gc_mark_movable(value);
+      }
+      else
+      {
+        rb_gc_mark(value);
+      }
+    }
+  }
+
+  inline void Wrapper::ruby_compact()
+  {
+    for (VALUE& value : this->keepAlive_)
+    {
+      value = rb_gc_location(value);
+    }
+
+    // If the wrapped object is tracked then the registry may point at our old location
+    Registries::instance.instances.compact(this->get());
+  }
+
+  inline void Wrapper::addKeepAlive(VALUE owner, VALUE value)
+  {
+    this->keepAlive_.push_back(value);
+
+    // Owner may be write barrier protected, so tell the garbage collector about the new reference
+    RB_OBJ_WRITTEN(owner, Qundef, value);
+  }
+
+  // Tells Ruby about memory owned by a wrapped object so that growing C++ allocations
+  // trigger garbage collections. Only done for types that opt in, for all other types
+  // this is an empty base class and thus takes no space.
+  template <typename T, bool = ruby_adjust_memory_usage<T>::value>
+  class MemoryUsage
+  {
+  protected:
+    void allocated(const T* data)
+    {
+    }
+
+    void freed()
+    {
+    }
+  };
 
   template <typename T>
-  class WrapperValue : public Wrapper
+  class MemoryUsage<T, true>
+  {
+  protected:
+    void allocated(const T* data)
+    {
+      this->size_ = (ssize_t)ruby_memsize<T>(data);
+      rb_gc_adjust_memory_usage(this->size_);
+    }
+
+    // The object may have grown or shrunk since it was created, so subtract exactly
+    // what was added to keep Ruby's count balanced
+    void freed()
+    {
+      rb_gc_adjust_memory_usage(-this->size_);
+      this->size_ = 0;
+    }
+
+  private:
+    ssize_t size_ = 0;
+  };
+
+  template <typename T>
+  class WrapperValue : public Wrapper, private MemoryUsage<T>
   {
   public:
     WrapperValue(T& data): data_(std::move(data))
     {
+      this->allocated(&this->data_);
+    }
+
+    template <typename...Arg_Ts>
+    WrapperValue(std::in_place_t, Arg_Ts&&...args) : data_(std::forward<Arg_Ts>(args)...)
+    {
+      this->allocated(&this->data_);
     }
 
     ~WrapperValue()
     {
       Registries::instance.instances.remove(this->get());
+      this->freed();
     }
 
     void* get() override
@@ -1408,11 +2129,15 @@ namespace Rice::detail
   };
 
   template <typename T>
-  class WrapperPointer : public Wrapper
+  class WrapperPointer : public Wrapper, private MemoryUsage<T>
   {
   public:
     WrapperPointer(T* data, bool isOwner) : data_(data), isOwner_(isOwner)
     {
+      if (this->isOwner_ && this->data_)
+      {
+        this->allocated(this->data_);
+      }
     }
 
     ~WrapperPointer()
@@ -1421,6 +2146,7 @@ namespace Rice::detail
 
       if (this->isOwner_)
       {
+        this->freed();
         delete this->data_;
       }
     }
@@ -1439,7 +2165,7 @@ namespace Rice::detail
   template <typename T, typename Wrapper_T>
   inline VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T& data, bool isOwner)
   {
-    VALUE result = Registries::instance.instances.lookup(&data);
+    VALUE result = Registries::instance.instances.lookup(&data, rb_type);
 
     if (result != Qnil)
       return result;
@@ -1480,7 +2206,7 @@ namespace Rice::detail
   template <typename T, typename Wrapper_T>
   inline VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T* data, bool isOwner)
   {
-    VALUE result = Registries::instance.instances.lookup(data);
+    VALUE result = Registries::instance.instances.lookup(data, rb_type);
 
     if (result != Qnil)
       return result;
@@ -1521,9 +2247,32 @@ namespace Rice::detail
     
   inline Wrapper* getWrapper(VALUE value, rb_data_type_t* rb_type)
   {
-    Wrapper* wrapper = nullptr;
-    TypedData_Get_Struct(value, Wrapper, rb_type, wrapper);
-    return wrapper;
+    if (!isTypedData(value, rb_type))
+    {
+      // Raises a TypeError that names the expected type
+      protect(rb_check_typeddata, value, (const rb_data_type_t*)rb_type);
+    }
+
+    return getWrapper(value);
+  }
+
+  inline bool isTypedData(VALUE value, const rb_data_type_t* rb_type)
+  {
+    if (!RB_TYPE_P(value, RUBY_T_DATA) || !RTYPEDDATA_P(value))
+    {
+      return false;
+    }
+
+    // Most objects are instances of the exact type so check that first before walking
+    // the type's parents
+    const rb_data_type_t* valueType = RTYPEDDATA_TYPE(value);
+    return valueType == rb_type || rb_typeddata_inherited_p(valueType, rb_type);
+  }
+
+  inline bool isWrapped(VALUE value)
+  {
+    return RB_TYPE_P(value, RUBY_T_DATA) && RTYPEDDATA_P(value) &&
+           RTYPEDDATA_TYPE(value)->data == &wrappedTypeTag;
   }
 
   template <typename T>
@@ -1543,6 +2292,27 @@ namespace Rice::detail
     Registries::instance.instances.add(data, value);
   }
 
+  template <typename T, typename Wrapper_T, typename...Arg_Ts>
+  inline T* emplace(VALUE value, rb_data_type_t* rb_type, Arg_Ts&&...args)
+  {
+    // Construct the new object before touching the existing wrapper in case T's constructor throws.
+    // The new wrapper is owned here until it is installed in case value has the wrong type.
+    std::unique_ptr<Wrapper_T> wrapper(new Wrapper_T(std::in_place, std::forward<Arg_Ts>(args)...));
+    T* data = static_cast<T*>(wrapper->get());
+
+    Wrapper* existing = getWrapper(value, rb_type);
+    if (existing)
+    {
+      Registries::instance.instances.remove(existing->get());
+      delete existing;
+    }
+
+    RTYPEDDATA_DATA(value) = wrapper.release();
+
+    Registries::instance.instances.add(data, value);
+    return data;
+  }
+
   inline Wrapper* getWrapper(VALUE value)
   {
     // Turn off spurious warning on g++ 12
@@ -1588,7 +2358,37 @@ namespace Rice
     //! Is the returned value being kept alive?
     bool isKeepAlive() const;
 
+    //! Specifies that returned strings are binary (ASCII-8BIT)
+    /*! By default returned strings are tagged with Encoding.default_external
+     *  and transcoded to Encoding.default_internal if it is set. Binary and
+     *  UTF-8 strings are copied as is without transcoding.
+     */
+    Return& binary();
+
+    //! Are returned strings binary?
+    bool isBinary() const;
+
+    //! Specifies that returned strings are UTF-8
+    Return& utf8();
+
+    //! Are returned strings UTF-8?
+    bool isUtf8() const;
+
+    //! Specifies that returned strings are frozen and deduplicated
+    /*! Ruby keeps a table of interned strings, so a method that returns
+     *  the same few strings over and over, such as status or category
+     *  names, does not allocate a new Ruby string each time. This can
+     *  be combined with binary() and utf8().
+     */
+    Return& interned();
+
+    //! Are returned strings interned?
+    bool isInterned() const;
+
   private:
+    bool isBinary_ = false;
+    bool isUtf8_ = false;
+    bool isInterned_ = false;
     bool isKeepAlive_ = false;
     bool isOwner_ = false;
     bool isValue_ = false;
@@ -1634,6 +2434,41 @@ namespace Rice
   {
     return this->isKeepAlive_;
   }
+
+  inline Return& Return::binary()
+  {
+    this->isBinary_ = true;
+    this->isUtf8_ = false;
+    return *this;
+  }
+
+  inline bool Return::isBinary() const
+  {
+    return this->isBinary_;
+  }
+
+  inline Return& Return::utf8()
+  {
+    this->isUtf8_ = true;
+    this->isBinary_ = false;
+    return *this;
+  }
+
+  inline bool Return::isUtf8() const
+  {
+    return this->isUtf8_;
+  }
+
+  inline Return& Return::interned()
+  {
+    this->isInterned_ = true;
+    return *this;
+  }
+
+  inline bool Return::isInterned() const
+  {
+    return this->isInterned_;
+  }
 }  // Rice
 
 
@@ -1692,6 +2527,14 @@ namespace Rice
     template<typename Arg_Type>
     Arg_Type& defaultValue();
 
+    //! Return a pointer to the default value, or nullptr if there is none
+    /*! Converters look up the default once when a method is defined so that
+     *  calls which omit the argument only pay for a nil check. Throws
+     *  std::bad_any_cast if the default was not stored as Arg_Type.
+     */
+    template<typename Arg_Type>
+    Arg_Type* defaultValuePointer();
+
     //! Tell the receiving object to keep this argument alive
     //! until the receiving object is freed.
     Arg& keepAlive();
@@ -1705,6 +2548,30 @@ namespace Rice
     //! Returns if the argument should be treated as a value
     bool isValue() const;
 
+    //! Specifies that the argument is passed as a Ruby keyword argument
+    /*! The keyword is the argument's name. Keyword arguments can be
+     *  combined with default values:
+     *
+     *  \code
+     *    Arg("timeout").keyword() = 30
+     *  \endcode
+     */
+    Arg& keyword();
+
+    //! Returns if the argument is passed as a keyword argument
+    bool isKeyword() const;
+
+    //! Lock the Ruby string passed to this argument while the method runs
+    /*! A std::string_view parameter points directly at the Ruby string's
+     *  buffer. Locking the string with rb_str_locktmp makes Ruby raise an
+     *  exception if other Ruby code, for example on another thread while
+     *  the GVL is released, tries to modify it during the call.
+     */
+    Arg& lockString();
+
+    //! Returns if the Ruby string passed to this argument is locked during the call
+    bool isLockString() const;
+
   public:
     const std::string name;
     int32_t position = -1;
@@ -1714,6 +2581,8 @@ namespace Rice
     std::any defaultValue_;
     bool isValue_ = false;
     bool isKeepAlive_ = false;
+    bool isKeyword_ = false;
+    bool isLockString_ = false;
   };
 } // Rice
 
@@ -1747,31 +2616,149 @@ namespace Rice
     return std::any_cast<Arg_Type&>(this->defaultValue_);
   }
 
+  template<typename Arg_Type>
+  inline Arg_Type* Arg::defaultValuePointer()
+  {
+    return this->hasDefaultValue() ? &this->defaultValue<Arg_Type>() : nullptr;
+  }
+
   inline Arg& Arg::keepAlive()
   {
-    this->isKeepAlive_ = true;
-    return *this;
+    this->isKeepAlive_ = true;
+    return *this;
+  }
+
+  inline bool Arg::isKeepAlive() const
+  {
+    return this->isKeepAlive_;
+  }
+
+  inline Arg& Arg::setValue()
+  {
+    isValue_ = true;
+    return *this;
+  }
+
+  inline bool Arg::isValue() const
+  {
+    return isValue_;
+  }
+
+  inline Arg& Arg::keyword()
+  {
+    this->isKeyword_ = true;
+    return *this;
+  }
+
+  inline bool Arg::isKeyword() const
+  {
+    return this->isKeyword_;
+  }
+
+  inline Arg& Arg::lockString()
+  {
+    this->isLockString_ = true;
+    return *this;
+  }
+
+  inline bool Arg::isLockString() const
+  {
+    return this->isLockString_;
+  }
+} // Rice
+
+// =========   NoGVL.hpp   =========
+
+
+namespace Rice
+{
+  //! Helper for releasing Ruby's global VM lock (GVL) while a method runs
+  /*! Passing a NoGVL to define_method or define_function lets other Ruby
+   *  threads run while a long running C++ function executes:
+   *
+   *  \code
+   *    define_method("compress", &Compressor::compress, NoGVL());
+   *  \endcode
+   *
+   *  Rice converts the arguments from Ruby with the GVL held, releases it
+   *  while the C++ function runs and then reacquires it to convert the
+   *  result back to Ruby. Therefore the C++ function must not call the
+   *  Ruby API or touch Ruby objects in any way.
+   *
+   *  Ruby calls the optional unblocking function, from another thread,
+   *  when the calling thread is interrupted (for example by Thread#kill
+   *  or Ctrl-C). It should make the C++ function return early. The
+   *  unblocking data is the same for every call of the method, so it
+   *  cannot refer to the receiver or arguments of a particular call. See
+   *  rb_thread_call_without_gvl for details.
+   */
+  class NoGVL
+  {
+  public:
+    NoGVL() = default;
+
+    //! Specify an unblocking function and the data to pass to it
+    NoGVL(rb_unblock_function_t* unblockFunction, void* unblockData = nullptr);
+
+    //! Returns the unblocking function, or nullptr if there is none
+    rb_unblock_function_t* unblockFunction() const;
+
+    //! Returns the data passed to the unblocking function
+    void* unblockData() const;
+
+  private:
+    rb_unblock_function_t* unblockFunction_ = nullptr;
+    void* unblockData_ = nullptr;
+  };
+} // Rice
+
+
+// ---------   NoGVL.ipp   ---------
+namespace Rice
+{
+  inline NoGVL::NoGVL(rb_unblock_function_t* unblockFunction, void* unblockData)
+    : unblockFunction_(unblockFunction), unblockData_(unblockData)
+  {
   }
 
-  inline bool Arg::isKeepAlive() const
+  inline rb_unblock_function_t* NoGVL::unblockFunction() const
   {
-    return this->isKeepAlive_;
+    return this->unblockFunction_;
   }
 
-  inline Arg& Arg::setValue()
+  inline void* NoGVL::unblockData() const
   {
-    isValue_ = true;
-    return *this;
+    return this->unblockData_;
   }
+} // Rice
 
-  inline bool Arg::isValue() const
+
+// =========   Overload.hpp   =========
+
+namespace Rice
+{
+  //! Marks a function as an overload of an existing Ruby method
+  /*! By default defining a function with the same name as an existing
+   *  method replaces it, just like redefining a method in Ruby. Passing
+   *  an Overload to define_method or define_function instead adds the
+   *  function to the method's overloads:
+   *
+   *  \code
+   *    define_method<void(Canvas::*)(int, int)>("draw", &Canvas::draw)
+   *    .define_method<void(Canvas::*)(std::string)>("draw", &Canvas::draw, Overload());
+   *  \endcode
+   *
+   *  Functions with keyword arguments cannot be overloaded.
+   */
+  class Overload
   {
-    return isValue_;
-  }
+  };
 } // Rice
 
+
 // =========   MethodInfo.hpp   =========
 
+#include <optional>
 #include <vector>
 
 namespace Rice
@@ -1788,6 +2775,13 @@ namespace Rice
       */
     std::string formatString();
 
+    /**
+      * Get the arity Ruby should enforce for this list of
+      * arguments. This is the number of arguments, or -1 if
+      * any of them are optional or keyword arguments.
+      */
+    int arity();
+
     /**
       * Add a defined Arg to this list of Arguments
       */
@@ -1801,6 +2795,12 @@ namespace Rice
 
     Return returnInfo;
 
+    // Set if the GVL should be released while the method runs
+    std::optional<NoGVL> noGVL;
+
+    // Set if the method should be added to the overloads of an existing method
+    bool overload = false;
+
   private:
     template <typename Arg_T>
     void processArg(const Arg_T& arg);
@@ -1810,6 +2810,7 @@ namespace Rice
 }
 
 // ---------   MethodInfo.ipp   ---------
+#include <algorithm>
 #include <sstream>
 
 namespace Rice
@@ -1841,6 +2842,14 @@ namespace Rice
     {
       this->addArg(arg);
     }
+    else if constexpr (std::is_same_v<Arg_T, NoGVL>)
+    {
+      this->noGVL = arg;
+    }
+    else if constexpr (std::is_same_v<Arg_T, Overload>)
+    {
+      this->overload = true;
+    }
     else
     {
       this->returnInfo = arg;
@@ -1872,6 +2881,16 @@ namespace Rice
     return std::to_string(required) + std::to_string(optional);
   }
 
+  inline int MethodInfo::arity()
+  {
+    bool isVariable = std::any_of(this->args_.begin(), this->args_.end(), [](const Arg& arg)
+    {
+      return arg.hasDefaultValue() || arg.isKeyword();
+    });
+
+    return isVariable ? -1 : (int)this->args_.size();
+  }
+
   inline Arg& MethodInfo::arg(size_t pos)
   {
     return args_[pos];
@@ -1889,6 +2908,97 @@ namespace Rice
 }
 
 
+// =========   without_gvl.hpp   =========
+
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+
+#include <ruby/thread.h>
+
+namespace Rice::detail
+{
+  // Calls func with the values in the args tuple while Ruby's GVL is released. C++ exceptions
+  // cannot unwind through Ruby, so any exception func throws is rethrown after the GVL is
+  // reacquired. Func must not touch Ruby objects.
+  template<typename Function_T, typename Tuple_T>
+  auto without_gvl(const NoGVL& noGVL, Function_T&& func, Tuple_T&& args)
+    -> decltype(std::apply(std::forward<Function_T>(func), std::forward<Tuple_T>(args)));
+}
+
+// ---------   without_gvl.ipp   ---------
+
+namespace Rice::detail
+{
+  template<typename Function_T, typename Tuple_T>
+  inline auto without_gvl(const NoGVL& noGVL, Function_T&& func, Tuple_T&& args)
+    -> decltype(std::apply(std::forward<Function_T>(func), std::forward<Tuple_T>(args)))
+  {
+    using Result_T = decltype(std::apply(std::forward<Function_T>(func), std::forward<Tuple_T>(args)));
+
+    // References are stored as pointers and values in an optional since they may not be default constructible
+    using Storage_T = std::conditional_t<std::is_void_v<Result_T>, std::nullptr_t,
+                        std::conditional_t<std::is_reference_v<Result_T>, std::remove_reference_t<Result_T>*,
+                          std::optional<Result_T>>>;
+
+    struct Call
+    {
+      Function_T& func;
+      Tuple_T& args;
+      Storage_T result{};
+      std::exception_ptr exception;
+    } call{ func, args };
+
+    void* (*callback)(void*) = [](void* data) -> void*
+    {
+      Call* call = static_cast<Call*>(data);
+      try
+      {
+        if constexpr (std::is_void_v<Result_T>)
+        {
+          std::apply(std::forward<Function_T>(call->func), std::forward<Tuple_T>(call->args));
+        }
+        else if constexpr (std::is_reference_v<Result_T>)
+        {
+          call->result = &std::apply(std::forward<Function_T>(call->func), std::forward<Tuple_T>(call->args));
+        }
+        else
+        {
+          call->result.emplace(std::apply(std::forward<Function_T>(call->func), std::forward<Tuple_T>(call->args)));
+        }
+      }
+      catch (...)
+      {
+        call->exception = std::current_exception();
+      }
+      return nullptr;
+    };
+
+    // Ruby raises pending interrupts (Thread#raise, Thread#kill) when it reacquires the GVL
+    detail::protect(rb_thread_call_without_gvl, callback, (void*)&call, noGVL.unblockFunction(), noGVL.unblockData());
+
+    if (call.exception)
+    {
+      std::rethrow_exception(call.exception);
+    }
+
+    if constexpr (std::is_void_v<Result_T>)
+    {
+      return;
+    }
+    else if constexpr (std::is_reference_v<Result_T>)
+    {
+      return static_cast<Result_T>(*call.result);
+    }
+    else
+    {
+      return std::move(*call.result);
+    }
+  }
+}
+
+
 // =========   from_ruby.hpp   =========
 
 
@@ -1935,6 +3045,7 @@ namespace Rice::detail
 #ifndef Rice__detail__from_ruby__ipp_
 #define Rice__detail__from_ruby__ipp_
 
+#include <limits>
 #include <optional>
 #include <stdexcept>
 
@@ -1942,6 +3053,53 @@ namespace Rice::detail
    such as bool, int, float, etc. It also includes conversions for chars and strings */
 namespace Rice::detail
 {
+  // Fixnums that fit in the target type are converted inline. Everything else - Bignums,
+  // Floats, objects that implement to_int and out of range values - is passed to Ruby's
+  // conversion function, which can raise and thus has to be protected.
+  template<typename T, typename Function_T>
+  inline T integerFromRuby(VALUE value, Function_T convertFunc)
+  {
+    if (RB_LIKELY(RB_FIXNUM_P(value)))
+    {
+      long result = RB_FIX2LONG(value);
+
+      if constexpr (std::is_signed_v<T>)
+      {
+        if (result >= std::numeric_limits<T>::min() && result <= std::numeric_limits<T>::max())
+        {
+          return (T)result;
+        }
+      }
+      else
+      {
+        if (result >= 0 && (unsigned long)result <= std::numeric_limits<T>::max())
+        {
+          return (T)result;
+        }
+      }
+    }
+
+    return (T)protect(convertFunc, value);
+  }
+
+  // Floats (both Flonums and heap allocated) and Fixnums are converted inline. Other
+  // values need to be coerced by rb_num2dbl, which can raise.
+  inline double floatFromRuby(VALUE value)
+  {
+    if (RB_LIKELY(RB_FLOAT_TYPE_P(value)))
+    {
+      return call_unprotected(rb_float_value, value);
+    }
+    else if (RB_FIXNUM_P(value))
+    {
+      return (double)RB_FIX2LONG(value);
+    }
+    else
+    {
+      return protect(rb_num2dbl, value);
+    }
+  }
+
   // ===========  short  ============
   template<>
   class From_Ruby<short>
@@ -1949,7 +3107,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<short>())
     {
     }
 
@@ -1960,18 +3118,18 @@ namespace Rice::detail
 
     short convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<short>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2short_inline, value);
+        return integerFromRuby<short>(value, rb_num2short_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    short* defaultValue_ = nullptr;
   };
 
   template<>
@@ -1980,7 +3138,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<short>())
     {
     }
 
@@ -1991,19 +3149,19 @@ namespace Rice::detail
 
     short& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<short>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2short_inline, value);
+        this->converted_ = integerFromRuby<short>(value, rb_num2short_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    short* defaultValue_ = nullptr;
     short converted_ = 0;
   };
 
@@ -2024,7 +3182,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2short_inline, value);
+        this->converted_ = integerFromRuby<short>(value, rb_num2short_inline);
         return &this->converted_;
       }
     }
@@ -2040,7 +3198,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<int>())
     {
     }
 
@@ -2051,18 +3209,18 @@ namespace Rice::detail
 
     int convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<int>();
+        return *this->defaultValue_;
       }
       else
       {
-        return (int)protect(rb_num2long_inline, value);
+        return integerFromRuby<int>(value, rb_num2long_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    int* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2071,7 +3229,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<int>())
     {
     }
 
@@ -2082,19 +3240,19 @@ namespace Rice::detail
 
     int& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<int>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = (int)protect(rb_num2long_inline, value);
+        this->converted_ = integerFromRuby<int>(value, rb_num2long_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    int* defaultValue_ = nullptr;
     int converted_ = 0;
   };
 
@@ -2115,7 +3273,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = (int)protect(rb_num2long_inline, value);
+        this->converted_ = integerFromRuby<int>(value, rb_num2long_inline);
         return &this->converted_;
       }
     }
@@ -2131,7 +3289,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<long>())
     {
     }
 
@@ -2142,18 +3300,18 @@ namespace Rice::detail
 
     long convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<long>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2long_inline, value);
+        return integerFromRuby<long>(value, rb_num2long_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    long* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2162,7 +3320,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<long>())
     {
     }
 
@@ -2173,19 +3331,19 @@ namespace Rice::detail
 
     long& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<long>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2long_inline, value);
+        this->converted_ = integerFromRuby<long>(value, rb_num2long_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    long* defaultValue_ = nullptr;
     long converted_ = 0;
   };
 
@@ -2206,7 +3364,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2long_inline, value);
+        this->converted_ = integerFromRuby<long>(value, rb_num2long_inline);
         return &this->converted_;
       }
     }
@@ -2222,7 +3380,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<long long>())
     {
     }
 
@@ -2233,18 +3391,18 @@ namespace Rice::detail
 
     long long convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<long long>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2ll_inline, value);
+        return integerFromRuby<long long>(value, rb_num2ll_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    long long* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2253,7 +3411,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<long long>())
     {
     }
 
@@ -2264,19 +3422,19 @@ namespace Rice::detail
 
     long long& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<long long>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2ll_inline, value);
+        this->converted_ = integerFromRuby<long long>(value, rb_num2ll_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    long long* defaultValue_ = nullptr;
     long long converted_ = 0;
   };
 
@@ -2297,7 +3455,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2ll_inline, value);
+        this->converted_ = integerFromRuby<long long>(value, rb_num2ll_inline);
         return &this->converted_;
       }
     }
@@ -2313,7 +3471,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned short>())
     {
     }
 
@@ -2324,18 +3482,18 @@ namespace Rice::detail
 
     unsigned short convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned short>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2ushort, value);
+        return integerFromRuby<unsigned short>(value, rb_num2ushort);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    unsigned short* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2344,7 +3502,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned short>())
     {
     }
 
@@ -2355,19 +3513,19 @@ namespace Rice::detail
 
     unsigned short& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned short>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2ushort, value);
+        this->converted_ = integerFromRuby<unsigned short>(value, rb_num2ushort);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    unsigned short* defaultValue_ = nullptr;
     unsigned short converted_ = 0;
   };
 
@@ -2388,7 +3546,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2ushort, value);
+        this->converted_ = integerFromRuby<unsigned short>(value, rb_num2ushort);
         return &this->converted_;
       }
     }
@@ -2404,7 +3562,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned int>())
     {
     }
 
@@ -2415,18 +3573,18 @@ namespace Rice::detail
 
     unsigned int convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned int>();
+        return *this->defaultValue_;
       }
       else
       {
-        return (unsigned int)protect(rb_num2ulong_inline, value);
+        return integerFromRuby<unsigned int>(value, rb_num2ulong_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    unsigned int* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2435,7 +3593,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned int>())
     {
     }
 
@@ -2446,19 +3604,19 @@ namespace Rice::detail
 
     unsigned int& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned int>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = (unsigned int)protect(rb_num2ulong_inline, value);
+        this->converted_ = integerFromRuby<unsigned int>(value, rb_num2ulong_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    unsigned int* defaultValue_ = nullptr;
     unsigned int converted_ = 0;
   };
 
@@ -2479,7 +3637,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = (unsigned int)protect(rb_num2ulong_inline, value);
+        this->converted_ = integerFromRuby<unsigned int>(value, rb_num2ulong_inline);
         return &this->converted_;
       }
     }
@@ -2495,7 +3653,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : arg_(arg), defaultValue_(arg->defaultValuePointer<unsigned long>())
     {
     }
 
@@ -2510,18 +3668,19 @@ namespace Rice::detail
       {
         return (unsigned long)value;
       }
-      else if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      else if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned long>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2ulong_inline, value);
+        return integerFromRuby<unsigned long>(value, rb_num2ulong_inline);
       }
     }
   
   private:
     Arg* arg_ = nullptr;
+    unsigned long* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2530,7 +3689,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned long>())
     {
     }
 
@@ -2541,19 +3700,19 @@ namespace Rice::detail
 
     unsigned long& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned long>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2ulong_inline, value);
+        this->converted_ = integerFromRuby<unsigned long>(value, rb_num2ulong_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    unsigned long* defaultValue_ = nullptr;
     unsigned long converted_ = 0;
   };
 
@@ -2574,7 +3733,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2ulong_inline, value);
+        this->converted_ = integerFromRuby<unsigned long>(value, rb_num2ulong_inline);
         return &this->converted_;
       }
     }
@@ -2590,7 +3749,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : arg_(arg), defaultValue_(arg->defaultValuePointer<unsigned long long>())
     {
     }
 
@@ -2605,18 +3764,19 @@ namespace Rice::detail
       {
         return value;
       }
-      else if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      else if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned long long>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2ull, value);
+        return integerFromRuby<unsigned long long>(value, rb_num2ull);
       }
     }
   
   private:
     Arg* arg_ = nullptr;
+    unsigned long long* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2625,7 +3785,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned long long>())
     {
     }
 
@@ -2636,19 +3796,19 @@ namespace Rice::detail
 
     unsigned long long& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned long long>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2ull, value);
+        this->converted_ = integerFromRuby<unsigned long long>(value, rb_num2ull);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    unsigned long long* defaultValue_ = nullptr;
     unsigned long long converted_ = 0;
   };
 
@@ -2669,7 +3829,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2ull, value);
+        this->converted_ = integerFromRuby<unsigned long long>(value, rb_num2ull);
         return &this->converted_;
       }
     }
@@ -2685,7 +3845,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<bool>())
     {
     }
 
@@ -2699,9 +3859,9 @@ namespace Rice::detail
 
     bool convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<bool>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -2710,7 +3870,7 @@ namespace Rice::detail
     }
   
   private:
-    Arg* arg_ = nullptr;
+    bool* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2719,7 +3879,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<bool>())
     {
     }
 
@@ -2733,9 +3893,9 @@ namespace Rice::detail
 
     bool& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<bool>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -2745,7 +3905,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    bool* defaultValue_ = nullptr;
     bool converted_ = false;
   };
 
@@ -2815,7 +3975,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<char>())
     {
     }
 
@@ -2826,9 +3986,9 @@ namespace Rice::detail
 
     char convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<char>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -2837,7 +3997,7 @@ namespace Rice::detail
     }
   
   private:
-    Arg* arg_ = nullptr;
+    char* defaultValue_ = nullptr;
   };
 
   template<>
@@ -2846,7 +4006,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<char>())
     {
     }
 
@@ -2857,9 +4017,9 @@ namespace Rice::detail
 
     char& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<char>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -2869,7 +4029,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    char* defaultValue_ = nullptr;
     char converted_ = 0;
   };
 
@@ -2890,7 +4050,7 @@ namespace Rice::detail
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
+        detail::checkString(value);
         return RSTRING_PTR(value);
       }
     }
@@ -2914,7 +4074,7 @@ namespace Rice::detail
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
+        detail::checkString(value);
         return RSTRING_PTR(value);
       }
     }
@@ -2927,7 +4087,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned char>())
     {
     }
 
@@ -2938,9 +4098,9 @@ namespace Rice::detail
 
     unsigned char convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned char>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -2949,7 +4109,7 @@ namespace Rice::detail
     }
   
   private:
-    Arg* arg_ = nullptr;
+    unsigned char* defaultValue_ = nullptr;
   };
 
   // ===========  signed char  ============
@@ -2959,7 +4119,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<signed char>())
     {
     }
 
@@ -2970,9 +4130,9 @@ namespace Rice::detail
 
     signed char convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<signed char>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -2981,7 +4141,7 @@ namespace Rice::detail
     }
   
   private:
-    Arg* arg_ = nullptr;
+    signed char* defaultValue_ = nullptr;
   };
 
   // ===========  double  ============
@@ -2991,7 +4151,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<double>())
     {
     }
 
@@ -3002,18 +4162,18 @@ namespace Rice::detail
 
     double convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<double>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2dbl, value);
+        return floatFromRuby(value);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    double* defaultValue_ = nullptr;
   };
 
   template<>
@@ -3022,7 +4182,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<double>())
     {
     }
 
@@ -3033,19 +4193,19 @@ namespace Rice::detail
 
     double& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<double>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2dbl, value);
+        this->converted_ = floatFromRuby(value);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    double* defaultValue_ = nullptr;
     double converted_;
   };
 
@@ -3066,7 +4226,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2dbl, value);
+        this->converted_ = floatFromRuby(value);
         return &this->converted_;
       }
     }
@@ -3082,7 +4242,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<float>())
     {
     }
 
@@ -3093,18 +4253,18 @@ namespace Rice::detail
 
     float convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<float>();
+        return *this->defaultValue_;
       }
       else
       {
-        return (float)protect(rb_num2dbl, value);
+        return (float)floatFromRuby(value);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    float* defaultValue_ = nullptr;
   };
 
   template<>
@@ -3113,7 +4273,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<float>())
     {
     }
 
@@ -3124,19 +4284,19 @@ namespace Rice::detail
 
     float& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<float>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = (float)protect(rb_num2dbl, value);
+        this->converted_ = (float)floatFromRuby(value);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    float* defaultValue_ = nullptr;
     float converted_;
   };
 
@@ -3157,7 +4317,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = (float)protect(rb_num2dbl, value);
+        this->converted_ = (float)floatFromRuby(value);
         return &this->converted_;
       }
     }
@@ -3224,10 +4384,168 @@ namespace Rice
 
 // ---------   to_ruby.ipp   ---------
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
 namespace Rice
 {
   namespace detail
   {
+    // Integers that fit in a Fixnum are converted inline. Larger values need a Bignum,
+    // which is allocated and thus has to be protected.
+    template<typename T>
+    inline bool isFixable(T x)
+    {
+      if constexpr (std::is_signed_v<T>)
+      {
+        return x >= RUBY_FIXNUM_MIN && x <= RUBY_FIXNUM_MAX;
+      }
+      else
+      {
+        return x <= (unsigned long)RUBY_FIXNUM_MAX;
+      }
+    }
+
+    // Doubles that can be stored as a Flonum do not need to be allocated, so rb_float_new
+    // cannot raise. This mirrors the range check in rb_float_new_inline.
+    inline bool isFlonum(double x)
+    {
+#if USE_FLONUM
+      uint64_t bits;
+      std::memcpy(&bits, &x, sizeof(bits));
+      int exponent = (int)((bits >> 60) & 0x7);
+      return bits == 0 || (bits != 0x3000000000000000 && !((exponent - 3) & ~0x01));
+#else
+      return false;
+#endif
+    }
+
+    // Returns the frozen, deduplicated string for the given bytes. If the string has already
+    // been interned this does not allocate.
+    inline VALUE internedStringToRuby(const char* data, long length, rb_encoding* encoding)
+    {
+#if RUBY_API_VERSION_MAJOR >= 3
+      return protect(rb_enc_interned_str, data, length, encoding);
+#else
+      VALUE string = protect(rb_enc_str_new, data, length, encoding);
+      return protect(rb_funcallv, string, rb_intern("-@"), 0, nullptr);
+#endif
+    }
+
+    // Creates a Ruby string with the encoding requested by the method's Return options
+    inline VALUE stringToRuby(const char* data, long length, Return* returnInfo)
+    {
+      bool interned = returnInfo && returnInfo->isInterned();
+
+      if (returnInfo && returnInfo->isBinary())
+      {
+        return interned ? internedStringToRuby(data, length, rb_ascii8bit_encoding()) :
+                          protect(rb_str_new, data, length);
+      }
+      else if (returnInfo && returnInfo->isUtf8())
+      {
+        return interned ? internedStringToRuby(data, length, rb_utf8_encoding()) :
+                          protect(rb_utf8_str_new, data, length);
+      }
+      else if (interned && !rb_default_internal_encoding())
+      {
+        return internedStringToRuby(data, length, rb_default_external_encoding());
+      }
+      else
+      {
+        // The string may have to be transcoded to Encoding.default_internal before it is interned
+        VALUE result = protect(rb_external_str_new, data, length);
+        return interned ? protect(rb_funcallv, result, rb_intern("-@"), 0, nullptr) : result;
+      }
+    }
+
+    // Caches the interned strings returned for char* results, keyed by pointer. Functions that
+    // return enum-like strings usually return string literals, so this skips hashing the string
+    // on every call. A hit still compares the contents in case the pointer has been reused.
+    class InternedStringCache
+    {
+    public:
+      static VALUE lookup(const char* data, rb_encoding* encoding);
+
+    private:
+      struct Entry
+      {
+        const char* data;
+        rb_encoding* encoding;
+      };
+
+      static constexpr long Size = 64;
+      inline static std::array<Entry, Size> entries_{};
+
+      // Holds the cached strings so they are not garbage collected
+      inline static VALUE strings_ = Qnil;
+    };
+
+    inline VALUE InternedStringCache::lookup(const char* data, rb_encoding* encoding)
+    {
+      if (strings_ == Qnil)
+      {
+        rb_gc_register_address(&strings_);
+        strings_ = protect(rb_ary_new_capa, Size);
+      }
+
+      long length = (long)strlen(data);
+      long index = (long)(std::hash<const char*>()(data) % Size);
+      Entry& entry = entries_[index];
+
+      if (entry.data == data && entry.encoding == encoding)
+      {
+        VALUE cached = call_unprotected(rb_ary_entry, strings_, index);
+        if (RSTRING_LEN(cached) == length && std::memcmp(RSTRING_PTR(cached), data, length) == 0)
+        {
+          return cached;
+        }
+      }
+
+      VALUE result = internedStringToRuby(data, length, encoding);
+      protect(rb_ary_store, strings_, index, result);
+      entry.data = data;
+      entry.encoding = encoding;
+      return result;
+    }
+
+    // Converts strings that start with ':' to Symbols. The ID is cached by the string's address
+    // so that a converter returning the same string literal on every call does not have to
+    // look it up again. A hit still compares the name in case the address has been reused.
+    class SymbolCache
+    {
+    public:
+      VALUE convert(const char* name, long length);
+
+    private:
+      const char* name_ = nullptr;
+      ID id_ = 0;
+      VALUE symbol_ = Qnil;
+    };
+
+    inline VALUE SymbolCache::convert(const char* name, long length)
+    {
+      if (name == this->name_)
+      {
+        const char* cached = call_unprotected(rb_id2name, this->id_);
+        if (cached && std::strncmp(cached, name, length) == 0 && cached[length] == '\0')
+        {
+          return this->symbol_;
+        }
+      }
+
+      this->id_ = protect(rb_intern2, name, length);
+      this->symbol_ = protect(rb_id2sym, this->id_);
+
+      // Only static symbols are immediate values. Dynamic ones are heap objects that the
+      // cache would have to keep alive, so they are not cached.
+      this->name_ = RB_STATIC_SYM_P(this->symbol_) ? name : nullptr;
+      return this->symbol_;
+    }
+
     template<>
     class To_Ruby<void>
     {
@@ -3254,6 +4572,10 @@ namespace Rice
     public:
       VALUE convert(short const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_int2num_inline, (int)x);
 #else
@@ -3268,6 +4590,10 @@ namespace Rice
     public:
       VALUE convert(short const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_int2num_inline, (int)x);
 #else
@@ -3282,6 +4608,10 @@ namespace Rice
     public:
       VALUE convert(int const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_int2num_inline, (int)x);
 #else
@@ -3296,6 +4626,10 @@ namespace Rice
     public:
       VALUE convert(int const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_int2num_inline, (int)x);
 #else
@@ -3310,6 +4644,10 @@ namespace Rice
     public:
       VALUE convert(long const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
         return protect(rb_long2num_inline, x);
       }
     };
@@ -3320,6 +4658,10 @@ namespace Rice
     public:
       VALUE convert(long const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
         return protect(rb_long2num_inline, x);
       }
     };
@@ -3330,6 +4672,10 @@ namespace Rice
     public:
       VALUE convert(long long const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
         return protect(rb_ll2inum, x);
       }
     };
@@ -3340,6 +4686,10 @@ namespace Rice
     public:
       VALUE convert(long long const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
         return protect(rb_ll2inum, x);
       }
     };
@@ -3350,6 +4700,10 @@ namespace Rice
     public:
       VALUE convert(unsigned short const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_uint2num_inline, (unsigned int)x);
 #else
@@ -3364,6 +4718,10 @@ namespace Rice
     public:
       VALUE convert(unsigned short const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_uint2num_inline, (unsigned int)x);
 #else
@@ -3378,6 +4736,10 @@ namespace Rice
     public:
       VALUE convert(unsigned int const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_uint2num_inline, (unsigned int)x);
 #else
@@ -3392,6 +4754,10 @@ namespace Rice
     public:
       VALUE convert(unsigned int const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_uint2num_inline, (unsigned int)x);
 #else
@@ -3418,6 +4784,10 @@ namespace Rice
         }
         else
         {
+          if (RB_LIKELY(isFixable(x)))
+          {
+            return RB_LONG2FIX((long)x);
+          }
           return protect(rb_ulong2num_inline, x);
         }
       }
@@ -3444,6 +4814,10 @@ namespace Rice
         }
         else
         {
+          if (RB_LIKELY(isFixable(x)))
+          {
+            return RB_LONG2FIX((long)x);
+          }
           return protect(rb_ulong2num_inline, x);
         }
       }
@@ -3470,6 +4844,10 @@ namespace Rice
         }
         else
         {
+          if (RB_LIKELY(isFixable(x)))
+          {
+            return RB_LONG2FIX((long)x);
+          }
           return protect(rb_ull2inum, (unsigned long long)x);
         }
       }
@@ -3496,6 +4874,10 @@ namespace Rice
         }
         else
         {
+          if (RB_LIKELY(isFixable(x)))
+          {
+            return RB_LONG2FIX((long)x);
+          }
           return protect(rb_ull2inum, (unsigned long long)x);
         }
       }
@@ -3510,6 +4892,10 @@ namespace Rice
     public:
       VALUE convert(float const& x)
       {
+        if (RB_LIKELY(isFlonum(x)))
+        {
+          return call_unprotected(rb_float_new, (double)x);
+        }
         return protect(rb_float_new, (double)x);
       }
     };
@@ -3520,6 +4906,10 @@ namespace Rice
     public:
       VALUE convert(float const& x)
       {
+        if (RB_LIKELY(isFlonum(x)))
+        {
+          return call_unprotected(rb_float_new, (double)x);
+        }
         return protect(rb_float_new, (double)x);
       }
     };
@@ -3530,6 +4920,10 @@ namespace Rice
     public:
       VALUE convert(double const& x)
       {
+        if (RB_LIKELY(isFlonum(x)))
+        {
+          return call_unprotected(rb_float_new, (double)x);
+        }
         return protect(rb_float_new, x);
       }
     };
@@ -3540,6 +4934,10 @@ namespace Rice
     public:
       VALUE convert(double const& x)
       {
+        if (RB_LIKELY(isFlonum(x)))
+        {
+          return call_unprotected(rb_float_new, (double)x);
+        }
         return protect(rb_float_new, x);
       }
     };
@@ -3628,22 +5026,37 @@ namespace Rice
     class To_Ruby<char*>
     {
     public:
+      To_Ruby() = default;
+
+      explicit To_Ruby(Return* returnInfo) : returnInfo_(returnInfo)
+      {
+      }
+
       VALUE convert(char const* x)
       {
-        if (strlen(x) > 0 && x[0] == ':')
+        if (x[0] == ':')
+        {
+          return this->symbolCache_.convert(x + 1, (long)std::strlen(x + 1));
+        }
+        else if (this->returnInfo_ && this->returnInfo_->isInterned())
+        {
+          // char* results are binary unless utf8() is specified
+          rb_encoding* encoding = this->returnInfo_->isUtf8() ? rb_utf8_encoding() : rb_ascii8bit_encoding();
+          return InternedStringCache::lookup(x, encoding);
+        }
+        else if (this->returnInfo_ && this->returnInfo_->isUtf8())
         {
-          size_t symbolLength = strlen(x) - 1;
-          char* symbol = new char[symbolLength];
-          strncpy(symbol, x + 1, symbolLength);
-          ID id = protect(rb_intern2, symbol, (long)symbolLength);
-          delete[] symbol;
-          return protect(rb_id2sym, id);
+          return protect(rb_utf8_str_new_cstr, x);
         }
         else
         {
           return protect(rb_str_new2, x);
         }
       }
+
+    private:
+      Return* returnInfo_ = nullptr;
+      SymbolCache symbolCache_;
     };
 
     template<int N>
@@ -3654,18 +5067,18 @@ namespace Rice
       {
         if (N > 0 && x[0] == ':')
         {
-          // N count includes a NULL character at the end of the string
-          constexpr size_t symbolLength = N - 1;
-          char symbol[symbolLength];
-          strncpy(symbol, x + 1, symbolLength);
-          ID id = protect(rb_intern, symbol);
-          return protect(rb_id2sym, id);
+          // The array may be longer than the string it holds
+          const char* end = std::find(x + 1, x + N, '\0');
+          return this->symbolCache_.convert(x + 1, (long)(end - x - 1));
         }
         else
         {
           return protect(rb_str_new2, x);
         }
       }
+
+    private:
+      SymbolCache symbolCache_;
     };
   }
 }
@@ -3802,7 +5215,7 @@ namespace Rice
 
   inline VALUE Exception::class_of() const
   {
-    return detail::protect(rb_class_of, this->exception_);
+    return detail::call_unprotected(rb_class_of, this->exception_);
   }
 
   inline VALUE Exception::value() const
@@ -3811,6 +5224,200 @@ namespace Rice
   }
 }
 
+// =========   NativeOverloads.hpp   =========
+
+#include <vector>
+
+
+namespace Rice::detail
+{
+  //! Dispatches a Ruby method to one of several overloaded C++ functions
+  /*! When C++ functions with different parameter types are defined with the same Ruby
+   *  class and method name, and the later ones are marked with Overload(), they are
+   *  combined into a NativeOverloads instance which is then bound to the Ruby method. When Ruby calls the method, NativeOverloads invokes
+   *  the first function whose parameters accept the arguments, as determined by
+   *  From_Ruby<T>::is_convertible.
+   *
+   *  Resolving an overload has to check every argument against every candidate. Thus
+   *  each overload set also has an inline cache that remembers the function chosen for
+   *  the last combination of argument types. Repeated calls with the same argument
+   *  types, which is by far the most common case, skip resolution altogether.
+   */
+  class NativeOverloads : public Native
+  {
+  public:
+    //! Overloads the native already bound to klass and method_id with native
+    /*! Returns false if there is no native to overload, or the existing native has
+     *  the same parameters, in which case the caller should bind native itself.
+     *  Throws if either native cannot be overloaded.
+     */
+    static bool define(VALUE klass, ID method_id, Native* native);
+
+    VALUE operator()(int argc, VALUE* argv, VALUE self) override;
+
+  private:
+    NativeOverloads(VALUE klass, ID method_id);
+
+    // Adds native to the set, replacing any native with the same signature
+    void add(Native* native);
+
+    // Returns the native to call for these arguments or nullptr if there is none
+    Native* resolve(int argc, VALUE* argv);
+
+    // The part of a value's type that determines which overload is chosen
+    static VALUE typeKey(VALUE value);
+
+    [[noreturn]] void noMatch(int argc, VALUE* argv);
+
+  private:
+    VALUE klass_;
+    ID method_id_;
+    RUBY_METHOD_FUNC trampoline_ = nullptr;
+    std::vector<Native*> natives_;
+
+    // Inline cache - the native chosen for the last call and its argument types
+    Native* cached_ = nullptr;
+    std::vector<VALUE> cachedKeys_;
+  };
+}
+
+// ---------   NativeOverloads.ipp   ---------
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace Rice::detail
+{
+  inline bool NativeOverloads::define(VALUE klass, ID method_id, Native* native)
+  {
+    NativeRegistry& natives = Registries::instance.natives;
+    Native* existing = natives.lookup(klass, method_id);
+
+    // The first definition of a method has nothing to overload
+    if (!existing)
+    {
+      return false;
+    }
+
+    NativeOverloads* overloads = dynamic_cast<NativeOverloads*>(existing);
+    if (!native->signature() || (!overloads && !existing->signature()))
+    {
+      std::string message = std::string("Cannot overload ") + rb_class2name(klass) + "#" + rb_id2name(method_id) +
+        ". Functions with keyword arguments, attributes and iterators cannot be overloaded.";
+      throw std::runtime_error(message);
+    }
+
+    if (!overloads)
+    {
+      // A native with the same parameters replaces the existing one, just like redefining a method in Ruby
+      if (*existing->signature() == *native->signature())
+      {
+        return false;
+      }
+
+      overloads = new NativeOverloads(klass, method_id);
+      overloads->add(existing);
+      overloads->trampoline_ = NativeSlots::claim<-1>(klass, method_id, overloads);
+    }
+
+    overloads->add(native);
+
+    // Overloads can have different numbers of arguments so the Ruby method has variable arity
+    detail::protect(rb_define_method_id, klass, method_id, overloads->trampoline_, -1);
+    return true;
+  }
+
+  inline NativeOverloads::NativeOverloads(VALUE klass, ID method_id) : klass_(klass), method_id_(method_id)
+  {
+  }
+
+  inline void NativeOverloads::add(Native* native)
+  {
+    auto iter = std::find_if(this->natives_.begin(), this->natives_.end(), [native](Native* overload)
+    {
+      return *overload->signature() == *native->signature();
+    });
+
+    if (iter == this->natives_.end())
+    {
+      this->natives_.push_back(native);
+    }
+    else
+    {
+      *iter = native;
+    }
+
+    this->cached_ = nullptr;
+  }
+
+  inline VALUE NativeOverloads::typeKey(VALUE value)
+  {
+    // Wrapped C++ objects are identified by their data type, which unlike their class can
+    // never be garbage collected. Everything else is identified by its builtin type.
+    if (rb_type(value) == RUBY_T_DATA && RTYPEDDATA_P(value))
+    {
+      return (VALUE)RTYPEDDATA_TYPE(value);
+    }
+    return (VALUE)rb_type(value);
+  }
+
+  inline Native* NativeOverloads::resolve(int argc, VALUE* argv)
+  {
+    // Check the inline cache first
+    bool hit = this->cached_ && argc == (int)this->cachedKeys_.size();
+    for (int i = 0; hit && i < argc; i++)
+    {
+      hit = this->cachedKeys_[i] == typeKey(argv[i]);
+    }
+
+    if (hit)
+    {
+      return this->cached_;
+    }
+
+    // Find the first native that accepts the arguments
+    auto iter = std::find_if(this->natives_.begin(), this->natives_.end(), [argc, argv](Native* native)
+    {
+      return native->matches(argc, argv);
+    });
+
+    if (iter == this->natives_.end())
+    {
+      return nullptr;
+    }
+
+    this->cached_ = *iter;
+    this->cachedKeys_.resize(argc);
+    std::transform(argv, argv + argc, this->cachedKeys_.begin(), typeKey);
+
+    return this->cached_;
+  }
+
+  inline void NativeOverloads::noMatch(int argc, VALUE* argv)
+  {
+    std::ostringstream types;
+    for (int i = 0; i < argc; i++)
+    {
+      types << (i > 0 ? ", " : "") << rb_obj_classname(argv[i]);
+    }
+
+    throw Exception(rb_eArgError, "No overload of %s#%s accepts the arguments (%s)",
+      rb_class2name(this->klass_), rb_id2name(this->method_id_), types.str().c_str());
+  }
+
+  inline VALUE NativeOverloads::operator()(int argc, VALUE* argv, VALUE self)
+  {
+    Native* native = this->resolve(argc, argv);
+    if (!native)
+    {
+      this->noMatch(argc, argv);
+    }
+    return (*native)(argc, argv, self);
+  }
+}
+
+
 // =========   NativeAttribute.hpp   =========
 
 
@@ -3826,7 +5433,7 @@ namespace Rice
   namespace detail
   {
     template<typename Attribute_T>
-    class NativeAttribute
+    class NativeAttribute : public Native
     {
     public:
       using NativeAttribute_T = NativeAttribute<Attribute_T>;
@@ -3839,12 +5446,6 @@ namespace Rice
       // Register attribute getter/setter with Ruby
       static void define(VALUE klass, std::string name, Attribute_T attribute, AttrAccess access = AttrAccess::ReadWrite);
 
-      // Static member functions that Ruby calls to read an attribute value
-      static VALUE get(VALUE self);
-
-      // Static member functions that Ruby calls to write an attribute value
-      static VALUE set(VALUE self, VALUE value);
-
     public:
       // Disallow creating/copying/moving
       NativeAttribute() = delete;
@@ -3853,6 +5454,9 @@ namespace Rice
       void operator=(const NativeAttribute_T&) = delete;
       void operator=(NativeAttribute_T&&) = delete;
 
+      // Reads the attribute if Ruby passes no arguments, otherwise writes it
+      VALUE operator()(int argc, VALUE* argv, VALUE self) override;
+
     protected:
       NativeAttribute(VALUE klass, std::string name, Attribute_T attr, AttrAccess access = AttrAccess::ReadWrite);
 
@@ -3885,11 +5489,10 @@ namespace Rice::detail
 
     if (access == AttrAccess::ReadWrite || access == AttrAccess::Read)
     {
-      // Tell Ruby to invoke the static method read to get the attribute value
-      detail::protect(rb_define_method, klass, name.c_str(), (RUBY_METHOD_FUNC)&NativeAttribute_T::get, 0);
-
-      // Add to native registry
-      detail::Registries::instance.natives.add(klass, Identifier(name).id(), native);
+      // Add to native registry and tell Ruby to invoke a trampoline bound to native to
+      // read the attribute value
+      RUBY_METHOD_FUNC trampoline = NativeSlots::claim<0>(klass, Identifier(name).id(), native);
+      detail::protect(rb_define_method, klass, name.c_str(), trampoline, 0);
     }
 
     if (access == AttrAccess::ReadWrite || access == AttrAccess::Write)
@@ -3902,41 +5505,31 @@ namespace Rice::detail
       // Define the write method name
       std::string setter = name + "=";
 
-      // Tell Ruby to invoke the static method write to get the attribute value
-      detail::protect(rb_define_method, klass, setter.c_str(), (RUBY_METHOD_FUNC)&NativeAttribute_T::set, 1);
-
-      // Add to native registry
-      detail::Registries::instance.natives.add(klass, Identifier(setter).id(), native);
+      // Add to native registry and tell Ruby to invoke a trampoline bound to native to
+      // write the attribute value
+      RUBY_METHOD_FUNC trampoline = NativeSlots::claim<1>(klass, Identifier(setter).id(), native);
+      detail::protect(rb_define_method, klass, setter.c_str(), trampoline, 1);
     }
   }
 
   template<typename Attribute_T>
-  inline VALUE NativeAttribute<Attribute_T>::get(VALUE self)
+  NativeAttribute<Attribute_T>::NativeAttribute(VALUE klass, std::string name,
+                                                             Attribute_T attribute, AttrAccess access)
+    : klass_(klass), name_(name), attribute_(attribute), access_(access)
   {
-    return cpp_protect([&]
-    {
-      using Native_Attr_T = NativeAttribute<Attribute_T>;
-      Native_Attr_T* attr = detail::Registries::instance.natives.lookup<Native_Attr_T*>();
-      return attr->read(self);
-    });
   }
 
   template<typename Attribute_T>
-  inline VALUE NativeAttribute<Attribute_T>::set(VALUE self, VALUE value)
+  inline VALUE NativeAttribute<Attribute_T>::operator()(int argc, VALUE* argv, VALUE self)
   {
-    return cpp_protect([&]
+    if (argc == 0)
     {
-      using Native_Attr_T = NativeAttribute<Attribute_T>;
-      Native_Attr_T* attr = detail::Registries::instance.natives.lookup<Native_Attr_T*>();
-      return attr->write(self, value);
-    });
-  }
-
-  template<typename Attribute_T>
-  NativeAttribute<Attribute_T>::NativeAttribute(VALUE klass, std::string name,
-                                                             Attribute_T attribute, AttrAccess access)
-    : klass_(klass), name_(name), attribute_(attribute), access_(access)
-  {
+      return this->read(self);
+    }
+    else
+    {
+      return this->write(self, argv[0]);
+    }
   }
 
   template<typename Attribute_T>
@@ -3970,6 +5563,9 @@ namespace Rice::detail
     {
       Receiver_T* nativeSelf = From_Ruby<Receiver_T*>().convert(self);
       nativeSelf->*attribute_ = From_Ruby<T_Unqualified>().convert(value);
+
+      // The attribute may hold a reference to value that a custom ruby_mark marks
+      RB_OBJ_WRITTEN(self, Qundef, value);
     }
     else if constexpr (!std::is_const_v<std::remove_pointer_t<T>>)
     {
@@ -3983,17 +5579,19 @@ namespace Rice::detail
 
 // =========   NativeFunction.hpp   =========
 
+#include <array>
+#include <vector>
+
 
 namespace Rice::detail
 {
   //! The NativeFunction class calls C++ functions/methods/lambdas on behalf of Ruby
   /*! The NativeFunction class is an intermediate between Ruby and C++. Every method
    *  defined in Rice is associated with a NativeFuntion instance that is stored in
-   *  a unordered_map maintained by the MethodData class. The key is the Ruby class
-   *  and method.
+   *  the NativeRegistry. The key is the Ruby class and method.
    * 
-   *  When Ruby calls into C++ it invokes the static NativeFunction.call method. This
-   *  method then looks up the NativeFunction instance and calls its ->() operator.
+   *  When Ruby calls into C++ it invokes a trampoline function that is bound to the
+   *  NativeFunction instance (see NativeSlots) and calls its ->() operator.
    *
    *  The instance then converts each of the arguments passed from Ruby into their
    *  C++ equivalents. It then retrieves the C++ object (if there is one, Ruby could
@@ -4019,7 +5617,7 @@ namespace Rice::detail
    */
 
   template<typename Class_T, typename Function_T, bool IsMethod>
-  class NativeFunction
+  class NativeFunction : public Native
   {
   public:
     using NativeFunction_T = NativeFunction<Class_T, Function_T, IsMethod>;
@@ -4034,9 +5632,6 @@ namespace Rice::detail
     // Register function with Ruby
     static void define(VALUE klass, std::string method_name, Function_T function, MethodInfo* methodInfo);
 
-    // Static member function that Ruby calls
-    static VALUE call(int argc, VALUE* argv, VALUE self);
-
   public:
     // Disallow creating/copying/moving
     NativeFunction() = delete;
@@ -4046,7 +5641,11 @@ namespace Rice::detail
     void operator=(NativeFunction_T&&) = delete;
 
     // Invokes the wrapped function
-    VALUE operator()(int argc, VALUE* argv, VALUE self);
+    VALUE operator()(int argc, VALUE* argv, VALUE self) override;
+
+    // Overload resolution support
+    bool matches(int argc, VALUE* argv) override;
+    const std::type_info* signature() override;
 
   protected:
     NativeFunction(VALUE klass, std::string method_name, Function_T function, MethodInfo* methodInfo);
@@ -4060,13 +5659,25 @@ namespace Rice::detail
     From_Ruby_Args_Ts createFromRuby(std::index_sequence<I...>& indices);
 
     To_Ruby<Return_T> createToRuby();
+
+    // Can the Ruby values be converted to the function's parameters?
+    template<std::size_t...I>
+    bool isConvertible(int argc, VALUE* argv, std::index_sequence<I...>& indices);
+
+    template<std::size_t I>
+    bool isConvertible(VALUE value);
       
-    // Convert Ruby argv pointer to Ruby values
-    std::vector<VALUE> getRubyValues(int argc, VALUE* argv);
+    // Convert Ruby argv pointer to Ruby values. These are stored on the stack
+    // so they are visible to Ruby's garbage collector
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> getRubyValues(int argc, VALUE* argv);
 
-    // Convert Ruby values to C++ values
+    // Removes the keyword arguments hash from the end of argv and returns it (or Qnil)
+    VALUE getKeywords(int& argc, VALUE* argv);
+
+    // Convert Ruby values to C++ values. The converters keep the storage that reference and
+    // pointer parameters point to, so they must outlive the call.
     template<typename std::size_t...I>
-    Arg_Ts getNativeValues(std::vector<VALUE>& values, std::index_sequence<I...>& indices);
+    Arg_Ts getNativeValues(From_Ruby_Args_Ts& fromRubys, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& values, std::index_sequence<I...>& indices);
 
     // Figure out what self is
     Receiver_T getReceiver(VALUE self);
@@ -4075,12 +5686,21 @@ namespace Rice::detail
     [[noreturn]] void noWrapper(const VALUE klass, const std::string& wrapper);
 
     // Do we need to keep alive any arguments?
-    void checkKeepAlive(VALUE self, VALUE returnValue, std::vector<VALUE>& rubyValues);
+    void checkKeepAlive(VALUE self, VALUE returnValue, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues);
+
+    // Call the C++ function with the arguments in a tuple, releasing the GVL if requested
+    template<typename Tuple_T>
+    decltype(auto) callFunction(Tuple_T&& args);
 
-    // Call the underlying C++ function
+    // Convert the Ruby values and call the underlying C++ function
+    VALUE invoke(VALUE self, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues);
+    VALUE invokeNative(VALUE self, const Arg_Ts& nativeValues);
     VALUE invokeNativeFunction(const Arg_Ts& nativeArgs);
     VALUE invokeNativeMethod(VALUE self, const Arg_Ts& nativeArgs);
 
+    // Same as invoke, but locks the strings passed to Arg::lockString() parameters for the duration of the call
+    VALUE invokeWithStringLocks(VALUE self, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues);
+
   private:
     VALUE klass_;
     std::string method_name_;
@@ -4088,12 +5708,27 @@ namespace Rice::detail
     From_Ruby_Args_Ts fromRubys_;
     To_Ruby<Return_T> toRuby_;
     std::unique_ptr<MethodInfo> methodInfo_;
+
+    // Computed once at definition time so calls do not have to inspect methodInfo_
+    int requiredCount_ = 0;
+    int positionalCount_ = 0;
+    bool hasKeepAlive_ = false;
+    bool hasStringLock_ = false;
+
+    // Index in argv of each argument, or -1 for keyword arguments
+    std::array<int, std::tuple_size_v<Arg_Ts>> argvIndexes_{};
+
+    // Keyword argument ids, with the required keywords first, and the position of each one
+    std::vector<ID> keywordIds_;
+    std::vector<size_t> keywordPositions_;
+    int requiredKeywordCount_ = 0;
   };
 }
 
 // ---------   NativeFunction.ipp   ---------
 #include <array>
 #include <algorithm>
+#include <memory>
 #include <stdexcept>
 #include <sstream>
 
@@ -4103,27 +5738,35 @@ namespace Rice::detail
   template<typename Class_T, typename Function_T, bool IsMethod>
   void NativeFunction<Class_T, Function_T, IsMethod>::define(VALUE klass, std::string method_name, Function_T function, MethodInfo* methodInfo)
   {
-    // Tell Ruby to invoke the static method call on this class
-    detail::protect(rb_define_method, klass, method_name.c_str(), (RUBY_METHOD_FUNC)&NativeFunction_T::call, -1);
-
-    // Now create a NativeFunction instance and save it to the natives registry keyed on
+    // Create a NativeFunction instance and save it to the natives registry keyed on
     // Ruby klass and method id. There may be multiple NativeFunction instances
     // because the same C++ method could be mapped to multiple Ruby methods.
-    NativeFunction_T* native = new NativeFunction_T(klass, method_name, std::forward<Function_T>(function), methodInfo);
-    detail::Registries::instance.natives.add(klass, Identifier(method_name).id(), native);
-  }
+    std::unique_ptr<NativeFunction_T> native(new NativeFunction_T(klass, method_name, std::forward<Function_T>(function), methodInfo));
+    ID method_id = Identifier(method_name).id();
 
-  template<typename Class_T, typename Function_T, bool IsMethod>
-  VALUE NativeFunction<Class_T, Function_T, IsMethod>::call(int argc, VALUE* argv, VALUE self)
-  {
-    // Look up the native function based on the Ruby klass and method id
-    NativeFunction_T* nativeFunction = detail::Registries::instance.natives.lookup<NativeFunction_T*>();
+    // Functions marked as overloads are added to the overloads of the existing method
+    if (methodInfo->overload && NativeOverloads::define(klass, method_id, native.get()))
+    {
+      native.release();
+      return;
+    }
 
-    // Execute the function but make sure to catch any C++ exceptions!
-    return cpp_protect([&]
+    // If no argument has a default value then register the method with its exact arity.
+    // Ruby then checks the number of arguments itself and passes them straight through.
+    constexpr int argCount = (int)std::tuple_size_v<Arg_Ts>;
+    if constexpr (argCount <= 15)
     {
-      return nativeFunction->operator()(argc, argv, self);
-    });
+      if (methodInfo->arity() == argCount)
+      {
+        RUBY_METHOD_FUNC trampoline = NativeSlots::claim<argCount>(klass, method_id, native.release());
+        detail::protect(rb_define_method, klass, method_name.c_str(), trampoline, argCount);
+        return;
+      }
+    }
+
+    // Otherwise tell Ruby to pass argc/argv and scan them ourselves
+    RUBY_METHOD_FUNC trampoline = NativeSlots::claim<-1>(klass, method_id, native.release());
+    detail::protect(rb_define_method, klass, method_name.c_str(), trampoline, -1);
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
@@ -4138,6 +5781,52 @@ namespace Rice::detail
     this->fromRubys_ = this->createFromRuby(indices);
 
     this->toRuby_ = this->createToRuby();
+
+    // Precompute what each call needs to know about the arguments. Positional arguments
+    // are passed in order in argv, keyword arguments are looked up by their interned ids.
+    for (const Arg& arg : *this->methodInfo_)
+    {
+      if (arg.isKeyword())
+      {
+        this->argvIndexes_[arg.position] = -1;
+      }
+      else
+      {
+        this->argvIndexes_[arg.position] = this->positionalCount_++;
+        if (!arg.hasDefaultValue())
+        {
+          this->requiredCount_++;
+        }
+      }
+    }
+
+    // rb_get_kwargs expects the required keywords to come first
+    for (bool required : { true, false })
+    {
+      for (const Arg& arg : *this->methodInfo_)
+      {
+        if (arg.isKeyword() && arg.hasDefaultValue() != required)
+        {
+          this->keywordIds_.push_back(Identifier(arg.name).id());
+          this->keywordPositions_.push_back(arg.position);
+          if (required)
+          {
+            this->requiredKeywordCount_++;
+          }
+        }
+      }
+    }
+
+    this->hasKeepAlive_ = this->methodInfo_->returnInfo.isKeepAlive() ||
+      std::any_of(this->methodInfo_->begin(), this->methodInfo_->end(), [](const Arg& arg)
+      {
+        return arg.isKeepAlive();
+      });
+
+    this->hasStringLock_ = std::any_of(this->methodInfo_->begin(), this->methodInfo_->end(), [](const Arg& arg)
+      {
+        return arg.isLockString();
+      });
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
@@ -4177,39 +5866,128 @@ namespace Rice::detail
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
-  std::vector<VALUE> NativeFunction<Class_T, Function_T, IsMethod>::getRubyValues(int argc, VALUE* argv)
+  std::array<VALUE, std::tuple_size_v<typename NativeFunction<Class_T, Function_T, IsMethod>::Arg_Ts>> NativeFunction<Class_T, Function_T, IsMethod>::getRubyValues(int argc, VALUE* argv)
   {
-    // Setup a tuple for the leading rb_scan_args arguments
-    std::string scanFormat = this->methodInfo_->formatString();
-    std::tuple<int, VALUE*, const char*> rbScanArgs = std::forward_as_tuple(argc, argv, scanFormat.c_str());
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> result;
+    VALUE keywords = this->getKeywords(argc, argv);
 
-    // Create a vector to store the VALUEs that will be returned by rb_scan_args
-    std::vector<VALUE> rbScanValues(std::tuple_size_v<Arg_Ts>, Qnil);
+    // Methods registered with their exact arity have already been checked by Ruby. Otherwise
+    // this does the same check as rb_scan_args, but with counts computed at definition time
+    if (argc < this->requiredCount_ || argc > this->positionalCount_)
+    {
+      detail::protect(rb_error_arity, argc, this->requiredCount_, this->positionalCount_);
+    }
 
-    // Convert the vector to an array so it can be concatenated to a tuple. As importantly
-    // fill it with pointers to rbScanValues
-    std::array<VALUE*, std::tuple_size_v<Arg_Ts>> rbScanValuePointers;
-    std::transform(rbScanValues.begin(), rbScanValues.end(), rbScanValuePointers.begin(),
-      [](VALUE& value)
+    // Optional arguments that were not passed are nil, From_Ruby will then use their default values
+    if (this->keywordIds_.empty())
+    {
+      if constexpr (std::tuple_size_v<Arg_Ts> > 0)
       {
-        return &value;
-      });
+        std::copy(argv, argv + argc, result.begin());
+        std::fill(result.begin() + argc, result.end(), Qnil);
+      }
+      return result;
+    }
+
+    for (size_t i = 0; i < result.size(); i++)
+    {
+      int index = this->argvIndexes_[i];
+      result[i] = (index >= 0 && index < argc) ? argv[index] : Qnil;
+    }
+
+    // Extract the keyword arguments. Missing keywords are returned as Qundef and unknown
+    // keywords raise an ArgumentError.
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> keywordValues;
+    detail::protect(rb_get_kwargs, keywords, this->keywordIds_.data(), this->requiredKeywordCount_,
+      (int)this->keywordIds_.size() - this->requiredKeywordCount_, keywordValues.data());
+
+    for (size_t i = 0; i < this->keywordIds_.size(); i++)
+    {
+      result[this->keywordPositions_[i]] = (keywordValues[i] == Qundef) ? Qnil : keywordValues[i];
+    }
+
+    return result;
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  VALUE NativeFunction<Class_T, Function_T, IsMethod>::getKeywords(int& argc, VALUE* argv)
+  {
+    // Ruby passes keyword arguments as a hash after the positional arguments
+    if (!this->keywordIds_.empty() && argc > 0 && rb_keyword_given_p())
+    {
+      argc--;
+      return argv[argc];
+    }
+    return Qnil;
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  const std::type_info* NativeFunction<Class_T, Function_T, IsMethod>::signature()
+  {
+    // Overload resolution only looks at positional arguments, so functions with keyword
+    // arguments cannot be overloaded
+    return this->keywordIds_.empty() ? &typeid(Arg_Ts) : nullptr;
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  bool NativeFunction<Class_T, Function_T, IsMethod>::matches(int argc, VALUE* argv)
+  {
+    this->getKeywords(argc, argv);
+    if (argc < this->requiredCount_ || argc > this->positionalCount_)
+    {
+      return false;
+    }
+
+    auto indices = std::make_index_sequence<std::tuple_size_v<Arg_Ts>>{};
+    return this->isConvertible(argc, argv, indices);
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  template<std::size_t... I>
+  bool NativeFunction<Class_T, Function_T, IsMethod>::isConvertible(int argc, VALUE* argv, std::index_sequence<I...>& indices)
+  {
+    // Arguments that were not passed will use their default values
+    if constexpr (sizeof...(I) == 0)
+    {
+      return true;
+    }
+    else
+    {
+      return ((this->argvIndexes_[I] < 0 || this->argvIndexes_[I] >= argc || this->isConvertible<I>(argv[this->argvIndexes_[I]])) && ...);
+    }
+  }
 
-    // Combine the tuples and call rb_scan_args
-    std::apply(rb_scan_args, std::tuple_cat(rbScanArgs, rbScanValuePointers));
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  template<std::size_t I>
+  bool NativeFunction<Class_T, Function_T, IsMethod>::isConvertible(VALUE value)
+  {
+    const Arg& arg = this->methodInfo_->arg(I);
+    if (arg.isValue() || (value == Qnil && arg.hasDefaultValue()))
+    {
+      return true;
+    }
 
-    return rbScanValues;
+    // Converters that cannot check values accept anything and raise an exception if the conversion fails
+    using From_Ruby_T = std::tuple_element_t<I, From_Ruby_Args_Ts>;
+    if constexpr (has_is_convertible_v<From_Ruby_T>)
+    {
+      return std::get<I>(this->fromRubys_).is_convertible(value);
+    }
+    else
+    {
+      return true;
+    }
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
   template<std::size_t... I>
-  typename NativeFunction<Class_T, Function_T, IsMethod>::Arg_Ts NativeFunction<Class_T, Function_T, IsMethod>::getNativeValues(std::vector<VALUE>& values,
+  typename NativeFunction<Class_T, Function_T, IsMethod>::Arg_Ts NativeFunction<Class_T, Function_T, IsMethod>::getNativeValues(From_Ruby_Args_Ts& fromRubys, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& values,
      std::index_sequence<I...>& indices)
   {
     // Convert each Ruby value to its native value by calling the appropriate fromRuby instance.
     // Note that for fundamental types From_Ruby<Arg_Ts> will keep a copy of the native value
     // so it can be passed by reference or pointer to a native function.
-    return std::forward_as_tuple(std::get<I>(this->fromRubys_).convert(values[I])...);
+    return std::forward_as_tuple(std::get<I>(fromRubys).convert(values[I])...);
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
@@ -4244,18 +6022,108 @@ namespace Rice::detail
     }
   }
 
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  template<typename Tuple_T>
+  decltype(auto) NativeFunction<Class_T, Function_T, IsMethod>::callFunction(Tuple_T&& args)
+  {
+    if (this->methodInfo_->noGVL)
+    {
+      return detail::without_gvl(*this->methodInfo_->noGVL, this->function_, std::forward<Tuple_T>(args));
+    }
+    else
+    {
+      return std::apply(this->function_, std::forward<Tuple_T>(args));
+    }
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  VALUE NativeFunction<Class_T, Function_T, IsMethod>::invoke(VALUE self, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues)
+  {
+    auto indices = std::make_index_sequence<std::tuple_size_v<Arg_Ts>>{};
+
+    // Methods that release the GVL can be called again by another thread before they return,
+    // and that call's conversions would overwrite the values this call is using. Thus they
+    // convert into converters of their own.
+    if (this->methodInfo_->noGVL)
+    {
+      From_Ruby_Args_Ts fromRubys = this->createFromRuby(indices);
+      Arg_Ts nativeValues = this->getNativeValues(fromRubys, rubyValues, indices);
+      return this->invokeNative(self, nativeValues);
+    }
+    else
+    {
+      Arg_Ts nativeValues = this->getNativeValues(this->fromRubys_, rubyValues, indices);
+      return this->invokeNative(self, nativeValues);
+    }
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  VALUE NativeFunction<Class_T, Function_T, IsMethod>::invokeNative(VALUE self, const Arg_Ts& nativeValues)
+  {
+    if constexpr (std::is_same_v<Receiver_T, std::nullptr_t>)
+    {
+      return this->invokeNativeFunction(nativeValues);
+    }
+    else
+    {
+      return this->invokeNativeMethod(self, nativeValues);
+    }
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  VALUE NativeFunction<Class_T, Function_T, IsMethod>::invokeWithStringLocks(VALUE self, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues)
+  {
+    // Strings are locked before they are converted, so that converting the other arguments
+    // cannot run Ruby code that modifies them either. The same string can be passed to more
+    // than one parameter but can only be locked once. Frozen strings cannot be modified anyway.
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> locked;
+    size_t lockedCount = 0;
+
+    // rb_str_unlocktmp only raises if the string is not locked
+    auto unlock = [&]()
+    {
+      for (size_t i = 0; i < lockedCount; i++)
+      {
+        detail::call_unprotected(rb_str_unlocktmp, locked[i]);
+      }
+    };
+
+    try
+    {
+      for (const Arg& arg : *this->methodInfo_)
+      {
+        VALUE value = rubyValues[arg.position];
+        if (arg.isLockString() && rb_type(value) == RUBY_T_STRING && !RB_OBJ_FROZEN(value) &&
+            std::find(locked.begin(), locked.begin() + lockedCount, value) == locked.begin() + lockedCount)
+        {
+          detail::protect(rb_str_locktmp, value);
+          locked[lockedCount++] = value;
+        }
+      }
+
+      VALUE result = this->invoke(self, rubyValues);
+      unlock();
+      return result;
+    }
+    catch (...)
+    {
+      unlock();
+      throw;
+    }
+  }
+
   template<typename Class_T, typename Function_T, bool IsMethod>
   VALUE NativeFunction<Class_T, Function_T, IsMethod>::invokeNativeFunction(const Arg_Ts& nativeArgs)
   {
     if constexpr (std::is_void_v<Return_T>)
     {
-      std::apply(this->function_, nativeArgs);
+      this->callFunction(nativeArgs);
       return Qnil;
     }
     else
     {
       // Call the native method and get the result
-      Return_T nativeResult = std::apply(this->function_, nativeArgs);
+      Return_T nativeResult = (Return_T)this->callFunction(nativeArgs);
 
       // Return the result
       return this->toRuby_.convert(nativeResult);
@@ -4270,12 +6138,12 @@ namespace Rice::detail
 
     if constexpr (std::is_void_v<Return_T>)
     {
-      std::apply(this->function_, selfAndNativeArgs);
+      this->callFunction(selfAndNativeArgs);
       return Qnil;
     }
     else
     {
-      Return_T nativeResult = (Return_T)std::apply(this->function_, selfAndNativeArgs);
+      Return_T nativeResult = (Return_T)this->callFunction(selfAndNativeArgs);
 
       // Special handling if the method returns self. If so we do not want
       // to create a new Ruby wrapper object and instead return self.
@@ -4324,7 +6192,7 @@ namespace Rice::detail
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
-  void NativeFunction<Class_T, Function_T, IsMethod>::checkKeepAlive(VALUE self, VALUE returnValue, std::vector<VALUE>& rubyValues)
+  void NativeFunction<Class_T, Function_T, IsMethod>::checkKeepAlive(VALUE self, VALUE returnValue, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues)
   {
     // selfWrapper will be nullptr if this(self) is a builtin type and not an external(wrapped) type
     // it is highly unlikely that keepAlive is used in this case but we check anyway
@@ -4339,7 +6207,7 @@ namespace Rice::detail
         {
           noWrapper(self, "self");
         }
-        selfWrapper->addKeepAlive(rubyValues[arg.position]);
+        selfWrapper->addKeepAlive(self, rubyValues[arg.position]);
       }
     }
 
@@ -4357,7 +6225,7 @@ namespace Rice::detail
       {
         noWrapper(returnValue, "return");
       }
-      returnWrapper->addKeepAlive(self);
+      returnWrapper->addKeepAlive(returnValue, self);
     }
   }
 
@@ -4365,26 +6233,24 @@ namespace Rice::detail
   VALUE NativeFunction<Class_T, Function_T, IsMethod>::operator()(int argc, VALUE* argv, VALUE self)
   {
     // Get the ruby values
-    std::vector<VALUE> rubyValues = this->getRubyValues(argc, argv);
-
-    auto indices = std::make_index_sequence<std::tuple_size_v<Arg_Ts>>{};
-
-    // Convert the Ruby values to native values
-    Arg_Ts nativeValues = this->getNativeValues(rubyValues, indices);
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> rubyValues = this->getRubyValues(argc, argv);
 
     // Now call the native method
     VALUE result = Qnil;
-    if constexpr (std::is_same_v<Receiver_T, std::nullptr_t>)
+    if (this->hasStringLock_)
     {
-      result = this->invokeNativeFunction(nativeValues);
+      result = this->invokeWithStringLocks(self, rubyValues);
     }
     else
     {
-      result = this->invokeNativeMethod(self, nativeValues);
+      result = this->invoke(self, rubyValues);
     }
 
     // Check if any function arguments or return values need to have their lifetimes tied to the receiver
-    this->checkKeepAlive(self, result, rubyValues);
+    if (this->hasKeepAlive_)
+    {
+      this->checkKeepAlive(self, result, rubyValues);
+    }
 
     return result;
   }
@@ -4399,7 +6265,7 @@ namespace Rice::detail
 namespace Rice::detail
 {
   template<typename T, typename Iterator_Func_T>
-  class NativeIterator
+  class NativeIterator : public Native
   {
   public:
     using NativeIterator_T = NativeIterator<T, Iterator_Func_T>;
@@ -4411,9 +6277,6 @@ namespace Rice::detail
     // Register function with Ruby
     void static define(VALUE klass, std::string method_name, Iterator_Func_T begin, Iterator_Func_T end);
 
-    // Static member function that Ruby calls
-    static VALUE call(VALUE self);
-
   public:
     // Disallow creating/copying/moving
     NativeIterator() = delete;
@@ -4423,6 +6286,7 @@ namespace Rice::detail
     void operator=(NativeIterator_T&&) = delete;
 
     VALUE operator()(VALUE self);
+    VALUE operator()(int argc, VALUE* argv, VALUE self) override;
 
   protected:
     NativeIterator(VALUE klass, std::string method_name, Iterator_Func_T begin, Iterator_Func_T end);
@@ -4449,26 +6313,14 @@ namespace Rice::detail
   template <typename T, typename Iterator_Func_T>
   inline void NativeIterator<T, Iterator_Func_T>::define(VALUE klass, std::string method_name, Iterator_Func_T begin, Iterator_Func_T end)
   {
-    // Tell Ruby to invoke the static method call on this class
-    detail::protect(rb_define_method, klass, method_name.c_str(), (RUBY_METHOD_FUNC)&NativeIterator_T::call, 0);
-
-    // Now create a NativeIterator instance and save it to the natives registry keyed on
+    // Create a NativeIterator instance and save it to the natives registry keyed on
     // Ruby klass and method id. There may be multiple NativeIterator instances
     // because the same C++ method could be mapped to multiple Ruby methods.
     NativeIterator_T* native = new NativeIterator_T(klass, method_name, begin, end);
-    detail::Registries::instance.natives.add(klass, Identifier(method_name).id(), native);
-  }
 
-  template<typename T, typename Iterator_Func_T>
-  inline VALUE NativeIterator<T, Iterator_Func_T>::call(VALUE self)
-  {
-    // Look up the native function based on the Ruby klass and method id
-    NativeIterator_T* nativeIterator = detail::Registries::instance.natives.lookup<NativeIterator_T*>();
-
-    return cpp_protect([&]
-    {
-      return nativeIterator->operator()(self);
-    });
+    // Tell Ruby to invoke a trampoline bound to the instance
+    RUBY_METHOD_FUNC trampoline = NativeSlots::claim<0>(klass, Identifier(method_name).id(), native);
+    detail::protect(rb_define_method, klass, method_name.c_str(), trampoline, 0);
   }
 
   template <typename T, typename Iterator_Func_T>
@@ -4489,10 +6341,14 @@ namespace Rice::detail
         // Get the iterator instance
         using Iter_T = NativeIterator<T, Iterator_Func_T>;
         // Class is easy
-        VALUE klass = protect(rb_class_of, recv);
+        VALUE klass = call_unprotected(rb_class_of, recv);
         // Read the method_id from an attribute we added to the enumerator instance
         ID method_id = protect(rb_ivar_get, eobj, rb_intern("rice_method"));
-        Iter_T* iterator = detail::Registries::instance.natives.lookup<Iter_T*>(klass, method_id);
+        Iter_T* iterator = dynamic_cast<Iter_T*>(detail::Registries::instance.natives.lookup(klass, method_id));
+        if (!iterator)
+        {
+          throw std::runtime_error("Could not find iterator for enumerator");
+        }
 
         // Get the wrapped C++ instance
         T* receiver = detail::From_Ruby<T*>().convert(recv);
@@ -4517,6 +6373,12 @@ namespace Rice::detail
     return enumerator;
   }
 
+  template<typename T, typename Iterator_Func_T>
+  inline VALUE NativeIterator<T, Iterator_Func_T>::operator()(int argc, VALUE* argv, VALUE self)
+  {
+    return this->operator()(self);
+  }
+
   template<typename T, typename Iterator_Func_T>
   inline VALUE NativeIterator<T, Iterator_Func_T>::operator()(VALUE self)
   {
@@ -4553,6 +6415,157 @@ namespace Rice
   }
 }
 
+// =========   Vectorizer.hpp   =========
+
+#include <tuple>
+#include <type_traits>
+
+
+namespace Rice
+{
+  template<typename T>
+  class Data_Type;
+}
+
+namespace Rice::detail
+{
+  //! Applies a scalar C++ function to every element of a Ruby Array or wrapped std::vector
+  /*! Calling a scalar function once per element from a Ruby loop pays the full cost of
+   *  a Ruby to C++ method call for every element. Vectorizer instead creates a function
+   *  that takes the whole collection and loops over it in C++. The argument and return
+   *  value converters are created once per call, and the result Array is sized up front.
+   *
+   *  @tparam Function_T - The scalar function. Not counting self, it must take exactly one argument.
+   *  @tparam IsMethod - Whether the function has a self parameter (see NativeFunction)
+   */
+  template<typename Function_T, bool IsMethod>
+  class Vectorizer
+  {
+  public:
+    using Arg_Ts = typename method_traits<Function_T, IsMethod>::Arg_Ts;
+    using Receiver_T = typename method_traits<Function_T, IsMethod>::Class_T;
+    using Return_T = remove_cv_recursive_t<typename method_traits<Function_T, IsMethod>::Return_T>;
+
+    static_assert(std::tuple_size_v<Arg_Ts> == 1, "Vectorized functions must take exactly one argument");
+    using Arg_T = remove_cv_recursive_t<std::tuple_element_t<0, Arg_Ts>>;
+    using Element_T = intrinsic_type<Arg_T>;
+
+    //! Returns a function that takes a Ruby Array or wrapped std::vector (and self if IsMethod)
+    //! and returns a Ruby Array with the result of calling func on each element.
+    static auto vectorize(Function_T func);
+
+  private:
+    template<typename Call_T>
+    static VALUE map(VALUE values, Call_T&& call);
+
+    template<typename Call_T, typename Value_T>
+    static VALUE invoke(Call_T& call, To_Ruby<Return_T>& toRuby, Value_T&& value);
+  };
+}
+
+// ---------   Vectorizer.ipp   ---------
+#include <functional>
+#include <vector>
+
+
+namespace Rice::detail
+{
+  template<typename Function_T, bool IsMethod>
+  inline auto Vectorizer<Function_T, IsMethod>::vectorize(Function_T func)
+  {
+    // Make sure the element and result types have been previously seen by Rice
+    verifyType<Return_T>();
+    verifyTypes<Arg_Ts>();
+
+    if constexpr (IsMethod)
+    {
+      return [func](Receiver_T self, VALUE values) -> VALUE
+      {
+        return map(values, [&func, &self](auto&& value) -> decltype(auto)
+        {
+          return std::invoke(func, self, std::forward<decltype(value)>(value));
+        });
+      };
+    }
+    else
+    {
+      return [func](VALUE values) -> VALUE
+      {
+        return map(values, [&func](auto&& value) -> decltype(auto)
+        {
+          return std::invoke(func, std::forward<decltype(value)>(value));
+        });
+      };
+    }
+  }
+
+  template<typename Function_T, bool IsMethod>
+  template<typename Call_T, typename Value_T>
+  inline VALUE Vectorizer<Function_T, IsMethod>::invoke(Call_T& call, To_Ruby<Return_T>& toRuby, Value_T&& value)
+  {
+    if constexpr (std::is_void_v<Return_T>)
+    {
+      call(std::forward<Value_T>(value));
+      return Qnil;
+    }
+    else
+    {
+      return toRuby.convert(call(std::forward<Value_T>(value)));
+    }
+  }
+
+  template<typename Function_T, bool IsMethod>
+  template<typename Call_T>
+  inline VALUE Vectorizer<Function_T, IsMethod>::map(VALUE values, Call_T&& call)
+  {
+    To_Ruby<Return_T> toRuby;
+
+    // Ruby Arrays have their elements converted one at a time. The function can call back into
+    // Ruby and change the Array, so its length is checked again before reading each element.
+    if (rb_type(values) == RUBY_T_ARRAY)
+    {
+      From_Ruby<Arg_T> fromRuby;
+      VALUE result = protect(rb_ary_new_capa, RARRAY_LEN(values));
+
+      for (long i = 0; i < RARRAY_LEN(values); i++)
+      {
+        VALUE element = invoke(call, toRuby, fromRuby.convert(RARRAY_AREF(values, i)));
+        protect(rb_ary_push, result, element);
+      }
+      return result;
+    }
+
+    // Wrapped std::vectors are processed without converting their elements at all. Like Arrays
+    // they can change during the loop, which would invalidate iterators, so they are indexed instead.
+    using Vector_T = std::vector<Element_T>;
+    if (Data_Type<Vector_T>::is_bound() && isTypedData(values, Data_Type<Vector_T>::ruby_data_type()))
+    {
+      Vector_T* vector = unwrap<Vector_T>(values, Data_Type<Vector_T>::ruby_data_type());
+      VALUE result = protect(rb_ary_new_capa, (long)vector->size());
+
+      for (size_t i = 0; i < vector->size(); i++)
+      {
+        auto&& item = (*vector)[i];
+        VALUE element = Qnil;
+        if constexpr (std::is_pointer_v<Arg_T>)
+        {
+          element = invoke(call, toRuby, &item);
+        }
+        else
+        {
+          element = invoke(call, toRuby, item);
+        }
+        protect(rb_ary_push, result, element);
+      }
+      return result;
+    }
+
+    throw Exception(rb_eTypeError, "wrong argument type %s (expected Array or %s)",
+      rb_obj_classname(values), Data_Type<Vector_T>::is_bound() ? rb_class2name(Data_Type<Vector_T>::klass().value()) : "std::vector");
+  }
+}
+
+
 // C++ classes for using the Ruby API
 
 // =========   Object.hpp   =========
@@ -5189,6 +7202,20 @@ namespace Rice
     template <typename... Arg_Ts>
     static inline String format(char const* fmt, Arg_Ts&&...args);
 
+    //! Construct an empty binary String with room for capacity bytes.
+    /*! This lets C++ code build large results directly in Ruby's memory
+     *  instead of building a std::string that then has to be copied:
+     *
+     *  \code
+     *    String result = String::buffer(maxSize);
+     *    size_t size = compress(input, result.data(), maxSize);
+     *    result.set_length(size);
+     *  \endcode
+     *
+     *  Like all Ruby objects, the String must be created with the GVL held.
+     */
+    static String buffer(size_t capacity);
+
     //! Get the length of the String.
     /*! \return the length of the string.
      */
@@ -5203,6 +7230,17 @@ namespace Rice
     //! Return a pointer to the beginning of the underlying C string.
     char const* c_str() const;
 
+    //! Return a pointer to the underlying buffer for writing.
+    /*! Raises FrozenError if the string is frozen.
+     */
+    char* data();
+
+    //! Set the length of the string after writing to data().
+    /*! \param length the new length, which cannot exceed the capacity
+     *  of the string.
+     */
+    void set_length(size_t length);
+
     //! Return a copy of the string as an std::string.
     std::string str() const;
 
@@ -5261,6 +7299,11 @@ namespace Rice
     return s;
   }
 
+  inline String String::buffer(size_t capacity)
+  {
+    return String(detail::protect(rb_str_buf_new, (long)capacity));
+  }
+
   inline size_t String::length() const
   {
     return RSTRING_LEN(value());
@@ -5276,6 +7319,23 @@ namespace Rice
     return RSTRING_PTR(value());
   }
 
+  inline char* String::data()
+  {
+    detail::protect(rb_str_modify, value());
+    return RSTRING_PTR(value());
+  }
+
+  inline void String::set_length(size_t length)
+  {
+    // Ruby aborts instead of raising an exception if the length is too long
+    size_t capacity = detail::call_unprotected(rb_str_capacity, value());
+    if (length > capacity)
+    {
+      throw Exception(rb_eArgError, "length %zu exceeds the string's capacity of %zu", length, capacity);
+    }
+    detail::protect(rb_str_set_len, value(), (long)length);
+  }
+
   inline std::string String::str() const
   {
     return std::string(RSTRING_PTR(value()), length());
@@ -5549,7 +7609,7 @@ namespace Rice
 
   inline Object Array::operator[](long index) const
   {
-    return detail::protect(rb_ary_entry, value(), position_of(index));
+    return detail::call_unprotected(rb_ary_entry, value(), position_of(index));
   }
 
   inline Array::Proxy Array::operator[](long index)
@@ -5599,12 +7659,12 @@ namespace Rice
 
   inline Array::Proxy::operator Object() const
   {
-    return detail::protect(rb_ary_entry, array_.value(), index_);
+    return detail::call_unprotected(rb_ary_entry, array_.value(), index_);
   }
 
   inline VALUE Array::Proxy::value() const
   {
-    return detail::protect(rb_ary_entry, array_.value(), index_);
+    return detail::call_unprotected(rb_ary_entry, array_.value(), index_);
   }
 
   template<typename T>
@@ -6444,6 +8504,39 @@ inline auto& define_function(std::string name, Function_T&& func, const Arg_Ts&.
   return *this;
 }
 
+//! Define a vectorized instance method.
+/*! Takes a scalar method whose only argument (besides self) is a single
+ *  element and defines a Ruby method that instead takes a Ruby Array, or
+ *  a wrapped std::vector, of elements. It returns an Array containing the
+ *  result of calling func on each element. The loop runs in C++ so its
+ *  cost is paid once per collection instead of once per element.
+ *  \param name the name of the method
+ *  \param func the implementation of the method for a single element,
+ *  either a member function pointer, plain function or lambda.
+ *  \return *this
+ */
+template<typename Function_T>
+inline auto& define_vectorized_method(std::string name, Function_T&& func)
+{
+  return define_method(name, detail::Vectorizer<Function_T, true>::vectorize(std::forward<Function_T>(func)),
+    Arg("values").setValue(), Return().setValue());
+}
+
+//! Define a vectorized instance function.
+/*! Same as define_vectorized_method except that func does not take a
+ *  self parameter.
+ *  \param name the name of the method
+ *  \param func the implementation of the function for a single element,
+ *  either a function pointer, static member function or lambda.
+ *  \return *this
+ */
+template<typename Function_T>
+inline auto& define_vectorized_function(std::string name, Function_T&& func)
+{
+  return define_function(name, detail::Vectorizer<Function_T, false>::vectorize(std::forward<Function_T>(func)),
+    Arg("values").setValue(), Return().setValue());
+}
+
 //! Define a singleton method.
 /*! The method's implementation can be a static member function,
 *   plain function or lambda. In all cases the first argument
@@ -6729,6 +8822,39 @@ inline auto& define_function(std::string name, Function_T&& func, const Arg_Ts&.
   return *this;
 }
 
+//! Define a vectorized instance method.
+/*! Takes a scalar method whose only argument (besides self) is a single
+ *  element and defines a Ruby method that instead takes a Ruby Array, or
+ *  a wrapped std::vector, of elements. It returns an Array containing the
+ *  result of calling func on each element. The loop runs in C++ so its
+ *  cost is paid once per collection instead of once per element.
+ *  \param name the name of the method
+ *  \param func the implementation of the method for a single element,
+ *  either a member function pointer, plain function or lambda.
+ *  \return *this
+ */
+template<typename Function_T>
+inline auto& define_vectorized_method(std::string name, Function_T&& func)
+{
+  return define_method(name, detail::Vectorizer<Function_T, true>::vectorize(std::forward<Function_T>(func)),
+    Arg("values").setValue(), Return().setValue());
+}
+
+//! Define a vectorized instance function.
+/*! Same as define_vectorized_method except that func does not take a
+ *  self parameter.
+ *  \param name the name of the method
+ *  \param func the implementation of the function for a single element,
+ *  either a function pointer, static member function or lambda.
+ *  \return *this
+ */
+template<typename Function_T>
+inline auto& define_vectorized_function(std::string name, Function_T&& func)
+{
+  return define_function(name, detail::Vectorizer<Function_T, false>::vectorize(std::forward<Function_T>(func)),
+    Arg("values").setValue(), Return().setValue());
+}
+
 //! Define a singleton method.
 /*! The method's implementation can be a static member function,
 *   plain function or lambda. In all cases the first argument
@@ -7285,6 +9411,8 @@ void Rice::define_global_function(char const * name, Function_T&& func, Arg_Ts c
 #ifndef ruby_mark__hpp
 #define ruby_mark__hpp
 
+#include <type_traits>
+
 //! Default function to call to mark a data object.
 /*! This function can be specialized for a particular type to override
  *  the default behavior (which is to not mark any additional objects).
@@ -7295,6 +9423,19 @@ namespace Rice
   void ruby_mark(T* data)
   {
   }
+
+  //! Whether wrapped objects of type T are write barrier protected.
+  /*! Write barrier protected objects are not rescanned by every minor garbage
+   *  collection, but every Ruby object they reference must be stored with
+   *  RB_OBJ_WRITE (or announced with RB_OBJ_WRITTEN). Rice does this for the
+   *  objects it stores itself, such as keepAlive references. It cannot know
+   *  what a custom ruby_mark function marks, so types opt in by specializing
+   *  this to std::true_type.
+   */
+  template<typename T>
+  struct ruby_wb_protected : std::false_type
+  {
+  };
 }
 #endif // ruby_mark__hpp
 
@@ -7342,6 +9483,12 @@ namespace Rice
       //! Get the Ruby object linked to this C++ instance
       Object getSelf() const { return self_; }
 
+      //! Called by Rice after GC compaction, which may have moved the Ruby object
+      void ruby_compact()
+      {
+        self_ = rb_gc_location(self_.value());
+      }
+
     private:
 
       // Save the Ruby object related to the instance of this class
@@ -7350,6 +9497,25 @@ namespace Rice
   };
 }
 
+namespace Rice::detail
+{
+  // Wrapper for Directors constructed from Ruby. Directors store their own Ruby object,
+  // which is not marked, so the wrapper updates it when GC compaction moves the object.
+  template <typename T>
+  class WrapperDirector : public WrapperValue<T>
+  {
+  public:
+    using WrapperValue<T>::WrapperValue;
+
+    void ruby_compact() override
+    {
+      WrapperValue<T>::ruby_compact();
+      static_cast<Director*>(static_cast<T*>(this->get()))->ruby_compact();
+    }
+  };
+}
+
+
 // =========   Data_Type.hpp   =========
 
 
@@ -7535,6 +9701,39 @@ inline auto& define_function(std::string name, Function_T&& func, const Arg_Ts&.
   return *this;
 }
 
+//! Define a vectorized instance method.
+/*! Takes a scalar method whose only argument (besides self) is a single
+ *  element and defines a Ruby method that instead takes a Ruby Array, or
+ *  a wrapped std::vector, of elements. It returns an Array containing the
+ *  result of calling func on each element. The loop runs in C++ so its
+ *  cost is paid once per collection instead of once per element.
+ *  \param name the name of the method
+ *  \param func the implementation of the method for a single element,
+ *  either a member function pointer, plain function or lambda.
+ *  \return *this
+ */
+template<typename Function_T>
+inline auto& define_vectorized_method(std::string name, Function_T&& func)
+{
+  return define_method(name, detail::Vectorizer<Function_T, true>::vectorize(std::forward<Function_T>(func)),
+    Arg("values").setValue(), Return().setValue());
+}
+
+//! Define a vectorized instance function.
+/*! Same as define_vectorized_method except that func does not take a
+ *  self parameter.
+ *  \param name the name of the method
+ *  \param func the implementation of the function for a single element,
+ *  either a function pointer, static member function or lambda.
+ *  \return *this
+ */
+template<typename Function_T>
+inline auto& define_vectorized_function(std::string name, Function_T&& func)
+{
+  return define_function(name, detail::Vectorizer<Function_T, false>::vectorize(std::forward<Function_T>(func)),
+    Arg("values").setValue(), Return().setValue());
+}
+
 //! Define a singleton method.
 /*! The method's implementation can be a static member function,
 *   plain function or lambda. In all cases the first argument
@@ -7687,6 +9886,12 @@ namespace Rice
     ruby_mark<T>(data);
   }
 
+  template<typename T>
+  void ruby_compact_internal(detail::Wrapper* wrapper)
+  {
+    wrapper->ruby_compact();
+  }
+
   template<typename T>
   void ruby_free_internal(detail::Wrapper* wrapper)
   {
@@ -7694,9 +9899,11 @@ namespace Rice
   }
 
   template<typename T>
-  size_t ruby_size_internal(const T* data)
+  size_t ruby_size_internal(const detail::Wrapper* wrapper)
   {
-    return sizeof(T);
+    // Getting the wrapped object does not modify the wrapper
+    const T* data = static_cast<const T*>(const_cast<detail::Wrapper*>(wrapper)->get());
+    return data ? ruby_memsize<T>(data) : 0;
   }
 
   template<typename T>
@@ -7716,8 +9923,15 @@ namespace Rice
     rb_data_type_->function.dmark = reinterpret_cast<void(*)(void*)>(&Rice::ruby_mark_internal<T>);
     rb_data_type_->function.dfree = reinterpret_cast<void(*)(void*)>(&Rice::ruby_free_internal<T>);
     rb_data_type_->function.dsize = reinterpret_cast<size_t(*)(const void*)>(&Rice::ruby_size_internal<T>);
-    rb_data_type_->data = nullptr;
+#if RUBY_API_VERSION_MAJOR > 2 || RUBY_API_VERSION_MINOR >= 7
+    rb_data_type_->function.dcompact = reinterpret_cast<void(*)(void*)>(&Rice::ruby_compact_internal<T>);
+#endif
+    rb_data_type_->data = &detail::wrappedTypeTag;
     rb_data_type_->flags = RUBY_TYPED_FREE_IMMEDIATELY;
+    if constexpr (ruby_wb_protected<T>::value)
+    {
+      rb_data_type_->flags |= RUBY_TYPED_WB_PROTECTED;
+    }
 
     if constexpr (!std::is_void_v<Base_T>)
     {
@@ -7986,8 +10200,7 @@ namespace Rice
   public:
     static void construct(VALUE self, Arg_Ts...args)
     {
-      T* data = new T(args...);
-      detail::replace<T>(self, Data_Type<T>::ruby_data_type(), data, true);
+      detail::emplace<T>(self, Data_Type<T>::ruby_data_type(), args...);
     }
   };
 
@@ -7998,8 +10211,14 @@ namespace Rice
     public:
       static void construct(Object self, Arg_Ts...args)
       {
-        T* data = new T(self, args...);
-        detail::replace<T>(self.value(), Data_Type<T>::ruby_data_type(), data, true);
+        if constexpr (std::is_base_of_v<Director, T>)
+        {
+          detail::emplace<T, detail::WrapperDirector<T>>(self.value(), Data_Type<T>::ruby_data_type(), self, args...);
+        }
+        else
+        {
+          detail::emplace<T>(self.value(), Data_Type<T>::ruby_data_type(), self, args...);
+        }
       }
   };
 }
@@ -8164,9 +10383,10 @@ namespace Rice
   template<typename T>
   inline T* Data_Object<T>::from_ruby(VALUE value)
   {
-    if (Data_Type<T>::is_descendant(value))
+    rb_data_type_t* rb_type = Data_Type<T>::ruby_data_type();
+    if (detail::isTypedData(value, rb_type))
     {
-      return detail::unwrap<T>(value, Data_Type<T>::ruby_data_type());
+      return detail::unwrap<T>(value, rb_type);
     }
     else
     {
@@ -8346,23 +10566,22 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg * arg) : arg_(arg)
+    explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<intrinsic_type<T>>())
     {
     }
     
     bool is_convertible(VALUE value)
     {
-      return rb_type(value) == RUBY_T_DATA &&
-        Data_Type<T>::is_descendant(value);
+      return detail::isTypedData(value, Data_Type<T>::ruby_data_type());
     }
 
     T convert(VALUE value)
     {
       using Intrinsic_T = intrinsic_type<T>;
 
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->template defaultValue<Intrinsic_T>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -8371,7 +10590,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    intrinsic_type<T>* defaultValue_ = nullptr;
   };
 
   template<typename T>
@@ -8382,23 +10601,22 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg * arg) : arg_(arg)
+    explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<intrinsic_type<T>>())
     {
     }
 
     bool is_convertible(VALUE value)
     {
-      return rb_type(value) == RUBY_T_DATA &&
-        Data_Type<T>::is_descendant(value);
+      return detail::isTypedData(value, Data_Type<T>::ruby_data_type());
     }
 
     T& convert(VALUE value)
     {
       using Intrinsic_T = intrinsic_type<T>;
 
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->template defaultValue<Intrinsic_T>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -8407,7 +10625,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    intrinsic_type<T>* defaultValue_ = nullptr;
   };
 
   template<typename T>
@@ -8418,8 +10636,7 @@ namespace Rice::detail
   public:
     bool is_convertible(VALUE value)
     {
-      return rb_type(value) == RUBY_T_DATA &&
-        Data_Type<T>::is_descendant(value);
+      return detail::isTypedData(value, Data_Type<T>::ruby_data_type());
     }
 
     T* convert(VALUE value)
@@ -8445,8 +10662,7 @@ namespace Rice::detail
   public:
     bool is_convertible(VALUE value)
     {
-      return rb_type(value) == RUBY_T_DATA &&
-             Data_Type<T>::is_descendant(value);
+      return detail::isTypedData(value, Data_Type<T>::ruby_data_type());
     }
 
     T* convert(VALUE value)
@@ -8679,7 +10895,7 @@ namespace Rice
   // These methods cannot be defined where they are declared due to circular dependencies
   inline Class Object::class_of() const
   {
-    return detail::protect(rb_class_of, value_);
+    return detail::call_unprotected(rb_class_of, value_);
   }
 
   inline String Object::to_s() const
@@ -19,24 +19,75 @@ namespace Rice::detail
     }
   };
 
+  template<>
+  struct HeapSize<std::string>
+  {
+    static size_t size(const std::string& data)
+    {
+      // Short strings are stored inside the string object itself
+      const char* buffer = data.data();
+      const char* object = reinterpret_cast<const char*>(&data);
+      bool isLocal = buffer >= object && buffer < object + sizeof(std::string);
+      return isLocal ? 0 : data.capacity() + 1;
+    }
+  };
+
+  // Converters for std::string& and std::string* live as long as the method and reuse their
+  // string for every call. Once a long argument grows that string, it would keep the memory
+  // forever, so the buffer is replaced when it is much bigger than the current argument.
+  inline void assignString(std::string& converted, VALUE value)
+  {
+    constexpr size_t maxRetainedCapacity = 4096;
+
+    const char* data = RSTRING_PTR(value);
+    size_t length = RSTRING_LEN(value);
+
+    if (converted.capacity() > maxRetainedCapacity && converted.capacity() > 2 * length)
+    {
+      std::string(data, length).swap(converted);
+    }
+    else
+    {
+      converted.assign(data, length);
+    }
+  }
+
   template<>
   class To_Ruby<std::string>
   {
   public:
+    To_Ruby() = default;
+
+    explicit To_Ruby(Return* returnInfo) : returnInfo_(returnInfo)
+    {
+    }
+
     VALUE convert(std::string const& x)
     {
-      return detail::protect(rb_external_str_new, x.data(), (long)x.size());
+      return stringToRuby(x.data(), (long)x.size(), this->returnInfo_);
     }
+
+  private:
+    Return* returnInfo_ = nullptr;
   };
 
   template<>
   class To_Ruby<std::string&>
   {
   public:
+    To_Ruby() = default;
+
+    explicit To_Ruby(Return* returnInfo) : returnInfo_(returnInfo)
+    {
+    }
+
     VALUE convert(std::string const& x)
     {
-      return detail::protect(rb_external_str_new, x.data(), (long)x.size());
+      return stringToRuby(x.data(), (long)x.size(), this->returnInfo_);
     }
+
+  private:
+    Return* returnInfo_ = nullptr;
   };
 
   template<>
@@ -45,7 +96,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<std::string>())
     {
     }
 
@@ -56,19 +107,19 @@ namespace Rice::detail
 
     std::string convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<std::string>();
+        return *this->defaultValue_;
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
+        detail::checkString(value);
         return std::string(RSTRING_PTR(value), RSTRING_LEN(value));
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::string* defaultValue_ = nullptr;
   };
 
   template<>
@@ -77,7 +128,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<std::string>())
     {
     }
 
@@ -88,20 +139,20 @@ namespace Rice::detail
 
     std::string& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<std::string>();
+        return *this->defaultValue_;
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
-        this->converted_ = std::string(RSTRING_PTR(value), RSTRING_LEN(value));
+        detail::checkString(value);
+        assignString(this->converted_, value);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::string* defaultValue_ = nullptr;
     std::string converted_;
   };
 
@@ -116,8 +167,8 @@ namespace Rice::detail
 
     std::string* convert(VALUE value)
     {
-      detail::protect(rb_check_type, value, (int)T_STRING);
-      this->converted_ = std::string(RSTRING_PTR(value), RSTRING_LEN(value));
+      detail::checkString(value);
+      assignString(this->converted_, value);
       return &this->converted_;
     }
 
@@ -136,8 +187,8 @@ namespace Rice::detail
 
     std::string* convert(VALUE value)
     {
-      detail::protect(rb_check_type, value, (int)T_STRING);
-      this->converted_ = std::string(RSTRING_PTR(value), RSTRING_LEN(value));
+      detail::checkString(value);
+      assignString(this->converted_, value);
       return &this->converted_;
     }
 
@@ -167,10 +218,19 @@ namespace Rice::detail
   class To_Ruby<std::string_view>
   {
   public:
+    To_Ruby() = default;
+
+    explicit To_Ruby(Return* returnInfo) : returnInfo_(returnInfo)
+    {
+    }
+
     VALUE convert(std::string_view const& x)
     {
-      return detail::protect(rb_external_str_new, x.data(), (long)x.size());
+      return stringToRuby(x.data(), (long)x.size(), this->returnInfo_);
     }
+
+  private:
+    Return* returnInfo_ = nullptr;
   };
 
   template<>
@@ -189,7 +249,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<std::string_view>())
     {
     }
 
@@ -200,19 +260,53 @@ namespace Rice::detail
 
     std::string_view convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<std::string_view>();
+        return *this->defaultValue_;
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
+        detail::checkString(value);
         return std::string_view(RSTRING_PTR(value), RSTRING_LEN(value));
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::string_view* defaultValue_ = nullptr;
+  };
+
+  template<>
+  class From_Ruby<std::string_view&>
+  {
+  public:
+    From_Ruby() = default;
+
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<std::string_view>())
+    {
+    }
+
+    bool is_convertible(VALUE value)
+    {
+      return rb_type(value) == RUBY_T_STRING;
+    }
+
+    std::string_view& convert(VALUE value)
+    {
+      if (value == Qnil && this->defaultValue_)
+      {
+        return *this->defaultValue_;
+      }
+      else
+      {
+        detail::checkString(value);
+        this->converted_ = std::string_view(RSTRING_PTR(value), RSTRING_LEN(value));
+        return this->converted_;
+      }
+    }
+
+  private:
+    std::string_view* defaultValue_ = nullptr;
+    std::string_view converted_;
   };
 }
 
@@ -306,6 +400,15 @@ namespace Rice::detail
     }
   };
 
+  template<typename T>
+  struct HeapSize<std::optional<T>>
+  {
+    static size_t size(const std::optional<T>& data)
+    {
+      return data ? elementHeapSize(*data) : 0;
+    }
+  };
+
   template<>
   class To_Ruby<std::nullopt_t>
   {
@@ -567,14 +670,14 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg * arg) : arg_(arg)
+    explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::shared_ptr<T>>())
     {
     }
 
     std::shared_ptr<T> convert(VALUE value)
     {
-      if(value == Qnil && this->arg_ && this->arg_->hasDefaultValue()) {
-        return this->arg_->template defaultValue<std::shared_ptr<T>>();
+      if(value == Qnil && this->defaultValue_) {
+        return *this->defaultValue_;
       }
 
       Wrapper* wrapper = detail::getWrapper(value, Data_Type<T>::ruby_data_type());
@@ -590,7 +693,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::shared_ptr<T>* defaultValue_ = nullptr;
   };
 
   template <typename T>
@@ -613,14 +716,14 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg * arg) : arg_(arg)
+    explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::shared_ptr<T>>())
     {
     }
 
     std::shared_ptr<T>& convert(VALUE value)
     {
-      if(value == Qnil && this->arg_ && this->arg_->hasDefaultValue()) {
-        return this->arg_->template defaultValue<std::shared_ptr<T>>();
+      if(value == Qnil && this->defaultValue_) {
+        return *this->defaultValue_;
       }
 
       Wrapper* wrapper = detail::getWrapper(value, Data_Type<T>::ruby_data_type());
@@ -636,7 +739,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::shared_ptr<T>* defaultValue_ = nullptr;
   };
 
   template<typename T>
@@ -726,6 +829,7 @@ namespace Rice::detail
 
 
 // ---------   variant.ipp   ---------
+#include <array>
 #include <variant>
 
 namespace Rice::detail
@@ -831,85 +935,163 @@ namespace Rice::detail
     }
   };
 
+  /* Chooses which alternative of a variant a Ruby value is converted to. The first
+     alternative whose From_Ruby converter accepts the value wins. Finding it means calling
+     is_convertible on each alternative in turn, which for wide variants is a long chain of
+     rb_type and rb_obj_is_kind_of calls per argument.
+
+     The converters decide based on a value's builtin type or, for wrapped C++ objects, its
+     class. Thus the first lookup for a given builtin type or class is remembered in a table
+     so later values are dispatched with a single lookup. Classes are cached, instead of
+     the object's rb_data_type_t, because a derived C++ object returned through a base
+     pointer is wrapped with the base's data type but its own class. */
   template<typename...Types>
-  class From_Ruby<std::variant<Types...>>
+  class VariantDispatcher
   {
+  public:
+    static std::variant<Types...> convert(VALUE value);
+
   private:
-    // Possible converters we could use for this variant
-    using From_Ruby_Ts = std::tuple<From_Ruby<Types>...>;
+    static int lookup(VALUE value);
+    static int lookupClass(VALUE value);
 
-  public:
-    /* This method loops over each type in the variant, creates a From_Ruby converter,
-       and then check if the converter can work with the provided Rby value (it checks
-       the type of the Ruby object to see if it matches the variant type). 
-       If yes, then the converter runs. If no, then the method recursively calls itself
-       increasing the index. 
-       
-       We use recursion, with a constexpr, to avoid having to instantiate an instance
-       of the variant to store results from a fold expression like the To_Ruby code
-       does above. That allows us to process variants with non default constructible
-       arguments like std::reference_wrapper. */
-    template <std::size_t I = 0>
-    std::variant<Types...> convertInternal(VALUE value)
+    template<std::size_t... I>
+    static int findAlternative(VALUE value, std::index_sequence<I...>& indices);
+
+    template<std::size_t I>
+    static std::variant<Types...> convertAlternative(VALUE value);
+
+    template<std::size_t I = 0>
+    static std::variant<Types...> convertIndex(int index, VALUE value);
+
+  private:
+    static_assert(sizeof...(Types) < 255, "Variant has too many alternatives");
+
+    // Entries store the index of the alternative plus one so that 0 means not yet looked up
+    inline static std::array<uint8_t, RUBY_T_MASK + 1> types_{};
+
+    static constexpr size_t ClassCount = 16;
+    inline static std::array<VALUE, ClassCount> classes_{};
+    inline static std::array<uint8_t, ClassCount> classIndexes_{};
+    inline static size_t classCount_ = 0;
+  };
+
+  template<typename...Types>
+  inline std::variant<Types...> VariantDispatcher<Types...>::convert(VALUE value)
+  {
+    return convertIndex(lookup(value), value);
+  }
+
+  template<typename...Types>
+  inline int VariantDispatcher<Types...>::lookup(VALUE value)
+  {
+    int type = rb_type(value);
+    if (type == RUBY_T_DATA)
     {
-      // Loop over each possible type in the variant.
-      if constexpr (I < std::variant_size_v<std::variant<Types...>>)
-      {
-        // Get the converter for the current index
-        typename std::tuple_element_t<I, From_Ruby_Ts> converter;
+      return lookupClass(value);
+    }
 
-        // See if it will work
-        if (converter.is_convertible(value))
-        {
-          return converter.convert(value);
-        }
-        else
-        {
-          return convertInternal<I + 1>(value);
-        }
+    uint8_t entry = types_[type];
+    if (RB_LIKELY(entry != 0))
+    {
+      return entry - 1;
+    }
+
+    auto indices = std::make_index_sequence<sizeof...(Types)>{};
+    int index = findAlternative(value, indices);
+    if (index >= 0)
+    {
+      types_[type] = (uint8_t)(index + 1);
+    }
+    return index;
+  }
+
+  template<typename...Types>
+  inline int VariantDispatcher<Types...>::lookupClass(VALUE value)
+  {
+    VALUE klass = call_unprotected(rb_obj_class, value);
+    for (size_t i = 0; i < classCount_; i++)
+    {
+      if (classes_[i] == klass)
+      {
+        return classIndexes_[i] - 1;
       }
-      throw std::runtime_error("Could not find converter for variant");
     }
 
-    std::variant<Types...> convert(VALUE value)
+    auto indices = std::make_index_sequence<sizeof...(Types)>{};
+    int index = findAlternative(value, indices);
+
+    // Once the table is full, further classes are looked up every time
+    if (index >= 0 && classCount_ < ClassCount)
     {
-      return convertInternal(value);
+      // The class is kept alive (and pinned) so its address cannot be reused by another class
+      rb_gc_register_address(&classes_[classCount_]);
+      classes_[classCount_] = klass;
+      classIndexes_[classCount_] = (uint8_t)(index + 1);
+      classCount_++;
     }
-  };
+
+    return index;
+  }
 
   template<typename...Types>
-  class From_Ruby<std::variant<Types...>&>
+  template<std::size_t... I>
+  inline int VariantDispatcher<Types...>::findAlternative(VALUE value, std::index_sequence<I...>& indices)
   {
-  private:
-    // Possible converters we could use for this variant
-    using From_Ruby_Ts = std::tuple<From_Ruby<Types>...>;
+    // Fold expression that stops at the first converter that accepts the value
+    int result = -1;
+    ((From_Ruby<std::variant_alternative_t<I, std::variant<Types...>>>().is_convertible(value) ?
+      (result = (int)I, true) : false) || ...);
+    return result;
+  }
 
-  public:
-    template <std::size_t I = 0>
-    std::variant<Types...> convertInternal(VALUE value)
+  template<typename...Types>
+  template<std::size_t I>
+  inline std::variant<Types...> VariantDispatcher<Types...>::convertAlternative(VALUE value)
+  {
+    From_Ruby<std::variant_alternative_t<I, std::variant<Types...>>> converter;
+    return std::variant<Types...>(std::in_place_index<I>, converter.convert(value));
+  }
+
+  template<typename...Types>
+  template<std::size_t I>
+  inline std::variant<Types...> VariantDispatcher<Types...>::convertIndex(int index, VALUE value)
+  {
+    // We use recursion, with a constexpr, instead of a fold expression to avoid having to
+    // instantiate an instance of the variant to store results. That allows us to process
+    // variants with non default constructible alternatives like std::reference_wrapper.
+    // Compilers turn this into a switch statement.
+    if constexpr (I < sizeof...(Types))
     {
-      // Loop over each possible type in the variant
-      if constexpr (I < std::variant_size_v<std::variant<Types...>>)
+      if (index == (int)I)
       {
-        // Get the converter for the current index
-        typename std::tuple_element_t<I, From_Ruby_Ts> converter;
-
-        // See if it will work
-        if (converter.is_convertible(value))
-        {
-          return converter.convert(value);
-        }
-        else
-        {
-          return convertInternal<I + 1>(value);
-        }
+        return convertAlternative<I>(value);
+      }
+      else
+      {
+        return convertIndex<I + 1>(index, value);
       }
-      throw std::runtime_error("Could not find converter for variant");
     }
+    throw std::runtime_error("Could not find converter for variant");
+  }
 
+  template<typename...Types>
+  class From_Ruby<std::variant<Types...>>
+  {
+  public:
+    std::variant<Types...> convert(VALUE value)
+    {
+      return VariantDispatcher<Types...>::convert(value);
+    }
+  };
+
+  template<typename...Types>
+  class From_Ruby<std::variant<Types...>&>
+  {
+  public:
     std::variant<Types...> convert(VALUE value)
     {
-      return convertInternal(value);
+      return VariantDispatcher<Types...>::convert(value);
     }
   };
 }
@@ -1102,6 +1284,15 @@ namespace Rice
         return true;
       }
     };
+
+    template<typename T1, typename T2>
+    struct HeapSize<std::pair<T1, T2>>
+    {
+      static size_t size(const std::pair<T1, T2>& data)
+      {
+        return elementHeapSize(data.first) + elementHeapSize(data.second);
+      }
+    };
   }
 }
 
@@ -1418,6 +1609,24 @@ namespace Rice
       }
     };
 
+    template<typename T, typename U>
+    struct HeapSize<std::map<T, U>>
+    {
+      static size_t size(const std::map<T, U>& data)
+      {
+        // Each element is stored in a tree node with parent, child and color fields
+        size_t result = data.size() * (sizeof(typename std::map<T, U>::value_type) + 4 * sizeof(void*));
+        if constexpr (!std::is_scalar_v<T> || !std::is_scalar_v<U>)
+        {
+          for (const auto& pair : data)
+          {
+            result += elementHeapSize(pair.first) + elementHeapSize(pair.second);
+          }
+        }
+        return result;
+      }
+    };
+
     template<typename T, typename U>
     struct MapFromHash
     {
@@ -1453,7 +1662,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::map<T, U>>())
       {
       }
 
@@ -1476,9 +1685,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::map<T, U>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -1490,7 +1699,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::map<T, U>* defaultValue_ = nullptr;
     };
 
     template<typename T, typename U>
@@ -1499,7 +1708,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::map<T, U>>())
       {
       }
 
@@ -1523,9 +1732,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::map<T, U>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -1537,7 +1746,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::map<T, U>* defaultValue_ = nullptr;
       std::map<T, U> converted_;
     };
 
@@ -1888,6 +2097,25 @@ namespace Rice
       }
     };
 
+    template<typename T, typename U>
+    struct HeapSize<std::unordered_map<T, U>>
+    {
+      static size_t size(const std::unordered_map<T, U>& data)
+      {
+        // Elements are stored in singly linked nodes that may cache their hash code
+        size_t result = data.bucket_count() * sizeof(void*) +
+                        data.size() * (sizeof(typename std::unordered_map<T, U>::value_type) + 2 * sizeof(void*));
+        if constexpr (!std::is_scalar_v<T> || !std::is_scalar_v<U>)
+        {
+          for (const auto& pair : data)
+          {
+            result += elementHeapSize(pair.first) + elementHeapSize(pair.second);
+          }
+        }
+        return result;
+      }
+    };
+
     template<typename T, typename U>
     struct UnorderedMapFromHash
     {
@@ -1923,7 +2151,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::unordered_map<T, U>>())
       {
       }
 
@@ -1946,9 +2174,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::unordered_map<T, U>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -1960,7 +2188,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::unordered_map<T, U>* defaultValue_ = nullptr;
     };
 
     template<typename T, typename U>
@@ -1969,7 +2197,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::unordered_map<T, U>>())
       {
       }
 
@@ -1993,9 +2221,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::unordered_map<T, U>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -2007,7 +2235,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::unordered_map<T, U>* defaultValue_ = nullptr;
       std::unordered_map<T, U> converted_;
     };
 
@@ -2062,6 +2290,7 @@ namespace Rice
 
 // ---------   vector.ipp   ---------
 
+#include <climits>
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
@@ -2434,16 +2663,77 @@ namespace Rice
       }
     };
 
+    template<typename T>
+    struct HeapSize<std::vector<T>>
+    {
+      static size_t size(const std::vector<T>& data)
+      {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+          // std::vector<bool> stores one bit per element
+          return data.capacity() / CHAR_BIT;
+        }
+        else
+        {
+          size_t result = data.capacity() * sizeof(T);
+          if constexpr (!std::is_scalar_v<T>)
+          {
+            for (const T& element : data)
+            {
+              result += elementHeapSize(element);
+            }
+          }
+          return result;
+        }
+      }
+    };
+
     template<typename T>
     std::vector<T> vectorFromArray(VALUE value)
     {
-      long length = protect(rb_array_len, value);
-      std::vector<T> result(length);
+      long length = call_unprotected(rb_array_len, value);
+      std::vector<T> result;
+      result.reserve(length);
+
+      // Arrays of wrapped C++ objects are unwrapped directly, comparing each element's data
+      // type inline instead of creating a From_Ruby converter per element
+      using Intrinsic_T = intrinsic_type<T>;
+      if constexpr (std::is_class_v<Intrinsic_T> && (std::is_same_v<T, Intrinsic_T*> || std::is_same_v<T, Intrinsic_T>))
+      {
+        if (Data_Type<Intrinsic_T>::is_bound())
+        {
+          rb_data_type_t* rb_type = Data_Type<Intrinsic_T>::ruby_data_type();
+
+          // Unwrapping does not call back into Ruby so the array cannot change underneath us
+          const VALUE* elements = RARRAY_CONST_PTR(value);
+          for (long i = 0; i < length; i++)
+          {
+            VALUE element = elements[i];
+            Wrapper* wrapper = isTypedData(element, rb_type) ? getWrapper(element) : nullptr;
+
+            if (!wrapper)
+            {
+              // Let the regular converter deal with nil and raise errors
+              result.emplace_back(From_Ruby<T>().convert(element));
+            }
+            else if constexpr (std::is_pointer_v<T>)
+            {
+              result.emplace_back(static_cast<Intrinsic_T*>(wrapper->get()));
+            }
+            else
+            {
+              result.emplace_back(*static_cast<Intrinsic_T*>(wrapper->get()));
+            }
+          }
+
+          return result;
+        }
+      }
 
       for (long i = 0; i < length; i++)
       {
-        VALUE element = protect(rb_ary_entry, value, i);
-        result[i] = From_Ruby<T>().convert(element);
+        VALUE element = call_unprotected(rb_ary_entry, value, i);
+        result.emplace_back(From_Ruby<T>().convert(element));
       }
 
       return result;
@@ -2455,7 +2745,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::vector<T>>())
       {
       }
 
@@ -2471,16 +2761,16 @@ namespace Rice
           case T_ARRAY:
           {
             // If this an Ruby array and the vector type is copyable
-            if constexpr (std::is_default_constructible_v<T>)
+            if constexpr (std::is_copy_constructible_v<T> || std::is_default_constructible_v<T>)
             {
               return vectorFromArray<T>(value);
             }
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::vector<T>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -2497,7 +2787,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::vector<T>* defaultValue_ = nullptr;
     };
 
     template<typename T>
@@ -2506,7 +2796,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::vector<T>>())
       {
       }
 
@@ -2522,7 +2812,7 @@ namespace Rice
           case T_ARRAY:
           {
             // If this an Ruby array and the vector type is copyable
-            if constexpr (std::is_default_constructible_v<T>)
+            if constexpr (std::is_copy_constructible_v<T> || std::is_default_constructible_v<T>)
             {
               this->converted_ = vectorFromArray<T>(value);
               return this->converted_;
@@ -2530,9 +2820,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::vector<T>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -2549,7 +2839,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::vector<T>* defaultValue_ = nullptr;
       std::vector<T> converted_;
     };
 
@@ -2569,7 +2859,7 @@ namespace Rice
           case T_ARRAY:
           {
             // If this an Ruby array and the vector type is copyable
-            if constexpr (std::is_default_constructible_v<T>)
+            if constexpr (std::is_copy_constructible_v<T> || std::is_default_constructible_v<T>)
             {
               this->converted_ = vectorFromArray<T>(value);
               return &this->converted_;
@@ -54,6 +54,14 @@ namespace Rice
     template<typename Arg_Type>
     Arg_Type& defaultValue();
 
+    //! Return a pointer to the default value, or nullptr if there is none
+    /*! Converters look up the default once when a method is defined so that
+     *  calls which omit the argument only pay for a nil check. Throws
+     *  std::bad_any_cast if the default was not stored as Arg_Type.
+     */
+    template<typename Arg_Type>
+    Arg_Type* defaultValuePointer();
+
     //! Tell the receiving object to keep this argument alive
     //! until the receiving object is freed.
     Arg& keepAlive();
@@ -67,6 +75,30 @@ namespace Rice
     //! Returns if the argument should be treated as a value
     bool isValue() const;
 
+    //! Specifies that the argument is passed as a Ruby keyword argument
+    /*! The keyword is the argument's name. Keyword arguments can be
+     *  combined with default values:
+     *
+     *  \code
+     *    Arg("timeout").keyword() = 30
+     *  \endcode
+     */
+    Arg& keyword();
+
+    //! Returns if the argument is passed as a keyword argument
+    bool isKeyword() const;
+
+    //! Lock the Ruby string passed to this argument while the method runs
+    /*! A std::string_view parameter points directly at the Ruby string's
+     *  buffer. Locking the string with rb_str_locktmp makes Ruby raise an
+     *  exception if other Ruby code, for example on another thread while
+     *  the GVL is released, tries to modify it during the call.
+     */
+    Arg& lockString();
+
+    //! Returns if the Ruby string passed to this argument is locked during the call
+    bool isLockString() const;
+
   public:
     const std::string name;
     int32_t position = -1;
@@ -76,6 +108,8 @@ namespace Rice
     std::any defaultValue_;
     bool isValue_ = false;
     bool isKeepAlive_ = false;
+    bool isKeyword_ = false;
+    bool isLockString_ = false;
   };
 } // Rice
 
@@ -26,6 +26,12 @@ namespace Rice
     return std::any_cast<Arg_Type&>(this->defaultValue_);
   }
 
+  template<typename Arg_Type>
+  inline Arg_Type* Arg::defaultValuePointer()
+  {
+    return this->hasDefaultValue() ? &this->defaultValue<Arg_Type>() : nullptr;
+  }
+
   inline Arg& Arg::keepAlive()
   {
     this->isKeepAlive_ = true;
@@ -47,4 +53,26 @@ namespace Rice
   {
     return isValue_;
   }
+
+  inline Arg& Arg::keyword()
+  {
+    this->isKeyword_ = true;
+    return *this;
+  }
+
+  inline bool Arg::isKeyword() const
+  {
+    return this->isKeyword_;
+  }
+
+  inline Arg& Arg::lockString()
+  {
+    this->isLockString_ = true;
+    return *this;
+  }
+
+  inline bool Arg::isLockString() const
+  {
+    return this->isLockString_;
+  }
 } // Rice
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "detail/Wrapper.hpp"
 #include "cpp_api/Object_defn.hpp"
+#include "Director.hpp"
 
 namespace Rice
 {
@@ -25,8 +26,7 @@ namespace Rice
   public:
     static void construct(VALUE self, Arg_Ts...args)
     {
-      T* data = new T(args...);
-      detail::replace<T>(self, Data_Type<T>::ruby_data_type(), data, true);
+      detail::emplace<T>(self, Data_Type<T>::ruby_data_type(), args...);
     }
   };
 
@@ -37,8 +37,14 @@ namespace Rice
     public:
       static void construct(Object self, Arg_Ts...args)
       {
-        T* data = new T(self, args...);
-        detail::replace<T>(self.value(), Data_Type<T>::ruby_data_type(), data, true);
+        if constexpr (std::is_base_of_v<Director, T>)
+        {
+          detail::emplace<T, detail::WrapperDirector<T>>(self.value(), Data_Type<T>::ruby_data_type(), self, args...);
+        }
+        else
+        {
+          detail::emplace<T>(self.value(), Data_Type<T>::ruby_data_type(), self, args...);
+        }
       }
   };
 }
@@ -72,9 +72,10 @@ namespace Rice
   template<typename T>
   inline T* Data_Object<T>::from_ruby(VALUE value)
   {
-    if (Data_Type<T>::is_descendant(value))
+    rb_data_type_t* rb_type = Data_Type<T>::ruby_data_type();
+    if (detail::isTypedData(value, rb_type))
     {
-      return detail::unwrap<T>(value, Data_Type<T>::ruby_data_type());
+      return detail::unwrap<T>(value, rb_type);
     }
     else
     {
@@ -254,23 +255,22 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg * arg) : arg_(arg)
+    explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<intrinsic_type<T>>())
     {
     }
     
     bool is_convertible(VALUE value)
     {
-      return rb_type(value) == RUBY_T_DATA &&
-        Data_Type<T>::is_descendant(value);
+      return detail::isTypedData(value, Data_Type<T>::ruby_data_type());
     }
 
     T convert(VALUE value)
     {
       using Intrinsic_T = intrinsic_type<T>;
 
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->template defaultValue<Intrinsic_T>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -279,7 +279,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    intrinsic_type<T>* defaultValue_ = nullptr;
   };
 
   template<typename T>
@@ -290,23 +290,22 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg * arg) : arg_(arg)
+    explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<intrinsic_type<T>>())
     {
     }
 
     bool is_convertible(VALUE value)
     {
-      return rb_type(value) == RUBY_T_DATA &&
-        Data_Type<T>::is_descendant(value);
+      return detail::isTypedData(value, Data_Type<T>::ruby_data_type());
     }
 
     T& convert(VALUE value)
     {
       using Intrinsic_T = intrinsic_type<T>;
 
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->template defaultValue<Intrinsic_T>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -315,7 +314,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    intrinsic_type<T>* defaultValue_ = nullptr;
   };
 
   template<typename T>
@@ -326,8 +325,7 @@ namespace Rice::detail
   public:
     bool is_convertible(VALUE value)
     {
-      return rb_type(value) == RUBY_T_DATA &&
-        Data_Type<T>::is_descendant(value);
+      return detail::isTypedData(value, Data_Type<T>::ruby_data_type());
     }
 
     T* convert(VALUE value)
@@ -353,8 +351,7 @@ namespace Rice::detail
   public:
     bool is_convertible(VALUE value)
     {
-      return rb_type(value) == RUBY_T_DATA &&
-             Data_Type<T>::is_descendant(value);
+      return detail::isTypedData(value, Data_Type<T>::ruby_data_type());
     }
 
     T* convert(VALUE value)
@@ -12,6 +12,7 @@
 #include "cpp_api/Class.hpp"
 #include "cpp_api/String.hpp"
 #include "ruby_mark.hpp"
+#include "ruby_memsize.hpp"
 
 #include <stdexcept>
 
@@ -28,6 +29,12 @@ namespace Rice
     ruby_mark<T>(data);
   }
 
+  template<typename T>
+  void ruby_compact_internal(detail::Wrapper* wrapper)
+  {
+    wrapper->ruby_compact();
+  }
+
   template<typename T>
   void ruby_free_internal(detail::Wrapper* wrapper)
   {
@@ -35,9 +42,11 @@ namespace Rice
   }
 
   template<typename T>
-  size_t ruby_size_internal(const T* data)
+  size_t ruby_size_internal(const detail::Wrapper* wrapper)
   {
-    return sizeof(T);
+    // Getting the wrapped object does not modify the wrapper
+    const T* data = static_cast<const T*>(const_cast<detail::Wrapper*>(wrapper)->get());
+    return data ? ruby_memsize<T>(data) : 0;
   }
 
   template<typename T>
@@ -57,8 +66,15 @@ namespace Rice
     rb_data_type_->function.dmark = reinterpret_cast<void(*)(void*)>(&Rice::ruby_mark_internal<T>);
     rb_data_type_->function.dfree = reinterpret_cast<void(*)(void*)>(&Rice::ruby_free_internal<T>);
     rb_data_type_->function.dsize = reinterpret_cast<size_t(*)(const void*)>(&Rice::ruby_size_internal<T>);
-    rb_data_type_->data = nullptr;
+#if RUBY_API_VERSION_MAJOR > 2 || RUBY_API_VERSION_MINOR >= 7
+    rb_data_type_->function.dcompact = reinterpret_cast<void(*)(void*)>(&Rice::ruby_compact_internal<T>);
+#endif
+    rb_data_type_->data = &detail::wrappedTypeTag;
     rb_data_type_->flags = RUBY_TYPED_FREE_IMMEDIATELY;
+    if constexpr (ruby_wb_protected<T>::value)
+    {
+      rb_data_type_->flags |= RUBY_TYPED_WB_PROTECTED;
+    }
 
     if constexpr (!std::is_void_v<Base_T>)
     {
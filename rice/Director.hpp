@@ -2,6 +2,7 @@
 #define Rice__Director__hpp_
 
 #include "cpp_api/Object.hpp"
+#include "detail/Wrapper.hpp"
 
 namespace Rice
 {
@@ -33,6 +34,12 @@ namespace Rice
       //! Get the Ruby object linked to this C++ instance
       Object getSelf() const { return self_; }
 
+      //! Called by Rice after GC compaction, which may have moved the Ruby object
+      void ruby_compact()
+      {
+        self_ = rb_gc_location(self_.value());
+      }
+
     private:
 
       // Save the Ruby object related to the instance of this class
@@ -40,4 +47,23 @@ namespace Rice
 
   };
 }
+
+namespace Rice::detail
+{
+  // Wrapper for Directors constructed from Ruby. Directors store their own Ruby object,
+  // which is not marked, so the wrapper updates it when GC compaction moves the object.
+  template <typename T>
+  class WrapperDirector : public WrapperValue<T>
+  {
+  public:
+    using WrapperValue<T>::WrapperValue;
+
+    void ruby_compact() override
+    {
+      WrapperValue<T>::ruby_compact();
+      static_cast<Director*>(static_cast<T*>(this->get()))->ruby_compact();
+    }
+  };
+}
+
 #endif // Rice__Director__hpp_
@@ -53,7 +53,7 @@ namespace Rice
 
   inline VALUE Exception::class_of() const
   {
-    return detail::protect(rb_class_of, this->exception_);
+    return detail::call_unprotected(rb_class_of, this->exception_);
   }
 
   inline VALUE Exception::value() const
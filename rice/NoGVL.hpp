@@ -0,0 +1,50 @@
+#ifndef Rice__NoGVL__hpp_
+#define Rice__NoGVL__hpp_
+
+#include "detail/ruby.hpp"
+
+namespace Rice
+{
+  //! Helper for releasing Ruby's global VM lock (GVL) while a method runs
+  /*! Passing a NoGVL to define_method or define_function lets other Ruby
+   *  threads run while a long running C++ function executes:
+   *
+   *  \code
+   *    define_method("compress", &Compressor::compress, NoGVL());
+   *  \endcode
+   *
+   *  Rice converts the arguments from Ruby with the GVL held, releases it
+   *  while the C++ function runs and then reacquires it to convert the
+   *  result back to Ruby. Therefore the C++ function must not call the
+   *  Ruby API or touch Ruby objects in any way.
+   *
+   *  Ruby calls the optional unblocking function, from another thread,
+   *  when the calling thread is interrupted (for example by Thread#kill
+   *  or Ctrl-C). It should make the C++ function return early. The
+   *  unblocking data is the same for every call of the method, so it
+   *  cannot refer to the receiver or arguments of a particular call. See
+   *  rb_thread_call_without_gvl for details.
+   */
+  class NoGVL
+  {
+  public:
+    NoGVL() = default;
+
+    //! Specify an unblocking function and the data to pass to it
+    NoGVL(rb_unblock_function_t* unblockFunction, void* unblockData = nullptr);
+
+    //! Returns the unblocking function, or nullptr if there is none
+    rb_unblock_function_t* unblockFunction() const;
+
+    //! Returns the data passed to the unblocking function
+    void* unblockData() const;
+
+  private:
+    rb_unblock_function_t* unblockFunction_ = nullptr;
+    void* unblockData_ = nullptr;
+  };
+} // Rice
+
+#include "NoGVL.ipp"
+
+#endif // Rice__NoGVL__hpp_
@@ -0,0 +1,17 @@
+namespace Rice
+{
+  inline NoGVL::NoGVL(rb_unblock_function_t* unblockFunction, void* unblockData)
+    : unblockFunction_(unblockFunction), unblockData_(unblockData)
+  {
+  }
+
+  inline rb_unblock_function_t* NoGVL::unblockFunction() const
+  {
+    return this->unblockFunction_;
+  }
+
+  inline void* NoGVL::unblockData() const
+  {
+    return this->unblockData_;
+  }
+} // Rice
@@ -0,0 +1,24 @@
+#ifndef Rice__Overload__hpp_
+#define Rice__Overload__hpp_
+
+namespace Rice
+{
+  //! Marks a function as an overload of an existing Ruby method
+  /*! By default defining a function with the same name as an existing
+   *  method replaces it, just like redefining a method in Ruby. Passing
+   *  an Overload to define_method or define_function instead adds the
+   *  function to the method's overloads:
+   *
+   *  \code
+   *    define_method<void(Canvas::*)(int, int)>("draw", &Canvas::draw)
+   *    .define_method<void(Canvas::*)(std::string)>("draw", &Canvas::draw, Overload());
+   *  \endcode
+   *
+   *  Functions with keyword arguments cannot be overloaded.
+   */
+  class Overload
+  {
+  };
+} // Rice
+
+#endif // Rice__Overload__hpp_
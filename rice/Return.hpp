@@ -28,7 +28,37 @@ namespace Rice
     //! Is the returned value being kept alive?
     bool isKeepAlive() const;
 
+    //! Specifies that returned strings are binary (ASCII-8BIT)
+    /*! By default returned strings are tagged with Encoding.default_external
+     *  and transcoded to Encoding.default_internal if it is set. Binary and
+     *  UTF-8 strings are copied as is without transcoding.
+     */
+    Return& binary();
+
+    //! Are returned strings binary?
+    bool isBinary() const;
+
+    //! Specifies that returned strings are UTF-8
+    Return& utf8();
+
+    //! Are returned strings UTF-8?
+    bool isUtf8() const;
+
+    //! Specifies that returned strings are frozen and deduplicated
+    /*! Ruby keeps a table of interned strings, so a method that returns
+     *  the same few strings over and over, such as status or category
+     *  names, does not allocate a new Ruby string each time. This can
+     *  be combined with binary() and utf8().
+     */
+    Return& interned();
+
+    //! Are returned strings interned?
+    bool isInterned() const;
+
   private:
+    bool isBinary_ = false;
+    bool isUtf8_ = false;
+    bool isInterned_ = false;
     bool isKeepAlive_ = false;
     bool isOwner_ = false;
     bool isValue_ = false;
@@ -35,4 +35,39 @@ namespace Rice
   {
     return this->isKeepAlive_;
   }
+
+  inline Return& Return::binary()
+  {
+    this->isBinary_ = true;
+    this->isUtf8_ = false;
+    return *this;
+  }
+
+  inline bool Return::isBinary() const
+  {
+    return this->isBinary_;
+  }
+
+  inline Return& Return::utf8()
+  {
+    this->isUtf8_ = true;
+    this->isBinary_ = false;
+    return *this;
+  }
+
+  inline bool Return::isUtf8() const
+  {
+    return this->isUtf8_;
+  }
+
+  inline Return& Return::interned()
+  {
+    this->isInterned_ = true;
+    return *this;
+  }
+
+  inline bool Return::isInterned() const
+  {
+    return this->isInterned_;
+  }
 }  // Rice
@@ -40,7 +40,7 @@ namespace Rice
 
   inline Object Array::operator[](long index) const
   {
-    return detail::protect(rb_ary_entry, value(), position_of(index));
+    return detail::call_unprotected(rb_ary_entry, value(), position_of(index));
   }
 
   inline Array::Proxy Array::operator[](long index)
@@ -90,12 +90,12 @@ namespace Rice
 
   inline Array::Proxy::operator Object() const
   {
-    return detail::protect(rb_ary_entry, array_.value(), index_);
+    return detail::call_unprotected(rb_ary_entry, array_.value(), index_);
   }
 
   inline VALUE Array::Proxy::value() const
   {
-    return detail::protect(rb_ary_entry, array_.value(), index_);
+    return detail::call_unprotected(rb_ary_entry, array_.value(), index_);
   }
 
   template<typename T>
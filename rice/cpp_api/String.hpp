@@ -45,6 +45,20 @@ namespace Rice
     template <typename... Arg_Ts>
     static inline String format(char const* fmt, Arg_Ts&&...args);
 
+    //! Construct an empty binary String with room for capacity bytes.
+    /*! This lets C++ code build large results directly in Ruby's memory
+     *  instead of building a std::string that then has to be copied:
+     *
+     *  \code
+     *    String result = String::buffer(maxSize);
+     *    size_t size = compress(input, result.data(), maxSize);
+     *    result.set_length(size);
+     *  \endcode
+     *
+     *  Like all Ruby objects, the String must be created with the GVL held.
+     */
+    static String buffer(size_t capacity);
+
     //! Get the length of the String.
     /*! \return the length of the string.
      */
@@ -59,6 +73,17 @@ namespace Rice
     //! Return a pointer to the beginning of the underlying C string.
     char const* c_str() const;
 
+    //! Return a pointer to the underlying buffer for writing.
+    /*! Raises FrozenError if the string is frozen.
+     */
+    char* data();
+
+    //! Set the length of the string after writing to data().
+    /*! \param length the new length, which cannot exceed the capacity
+     *  of the string.
+     */
+    void set_length(size_t length);
+
     //! Return a copy of the string as an std::string.
     std::string str() const;
 
@@ -43,6 +43,11 @@ namespace Rice
     return s;
   }
 
+  inline String String::buffer(size_t capacity)
+  {
+    return String(detail::protect(rb_str_buf_new, (long)capacity));
+  }
+
   inline size_t String::length() const
   {
     return RSTRING_LEN(value());
@@ -58,6 +63,23 @@ namespace Rice
     return RSTRING_PTR(value());
   }
 
+  inline char* String::data()
+  {
+    detail::protect(rb_str_modify, value());
+    return RSTRING_PTR(value());
+  }
+
+  inline void String::set_length(size_t length)
+  {
+    // Ruby aborts instead of raising an exception if the length is too long
+    size_t capacity = detail::call_unprotected(rb_str_capacity, value());
+    if (length > capacity)
+    {
+      throw Exception(rb_eArgError, "length %zu exceeds the string's capacity of %zu", length, capacity);
+    }
+    detail::protect(rb_str_set_len, value(), (long)length);
+  }
+
   inline std::string String::str() const
   {
     return std::string(RSTRING_PTR(value()), length());
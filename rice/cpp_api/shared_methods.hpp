@@ -57,6 +57,39 @@ inline auto& define_function(std::string name, Function_T&& func, const Arg_Ts&.
   return *this;
 }
 
+//! Define a vectorized instance method.
+/*! Takes a scalar method whose only argument (besides self) is a single
+ *  element and defines a Ruby method that instead takes a Ruby Array, or
+ *  a wrapped std::vector, of elements. It returns an Array containing the
+ *  result of calling func on each element. The loop runs in C++ so its
+ *  cost is paid once per collection instead of once per element.
+ *  \param name the name of the method
+ *  \param func the implementation of the method for a single element,
+ *  either a member function pointer, plain function or lambda.
+ *  \return *this
+ */
+template<typename Function_T>
+inline auto& define_vectorized_method(std::string name, Function_T&& func)
+{
+  return define_method(name, detail::Vectorizer<Function_T, true>::vectorize(std::forward<Function_T>(func)),
+    Arg("values").setValue(), Return().setValue());
+}
+
+//! Define a vectorized instance function.
+/*! Same as define_vectorized_method except that func does not take a
+ *  self parameter.
+ *  \param name the name of the method
+ *  \param func the implementation of the function for a single element,
+ *  either a function pointer, static member function or lambda.
+ *  \return *this
+ */
+template<typename Function_T>
+inline auto& define_vectorized_function(std::string name, Function_T&& func)
+{
+  return define_function(name, detail::Vectorizer<Function_T, false>::vectorize(std::forward<Function_T>(func)),
+    Arg("values").setValue(), Return().setValue());
+}
+
 //! Define a singleton method.
 /*! The method's implementation can be a static member function,
 *   plain function or lambda. In all cases the first argument
@@ -1,7 +1,7 @@
 #ifndef Rice__detail__InstanceRegistry__hpp_
 #define Rice__detail__InstanceRegistry__hpp_
 
-#include <map>
+#include <vector>
 #include "ruby.hpp"
 
 namespace Rice::detail
@@ -10,25 +10,47 @@ namespace Rice::detail
   {
   public:
     template <typename T>
-    VALUE lookup(T& cppInstance);
+    VALUE lookup(T& cppInstance, const rb_data_type_t* rbType);
 
     template <typename T>
-    VALUE lookup(T* cppInstance);
+    VALUE lookup(T* cppInstance, const rb_data_type_t* rbType);
 
     void add(void* cppInstance, VALUE rubyInstance);
     void remove(void* cppInstance);
     void clear();
 
+    // Updates the Ruby instance of cppInstance after GC compaction has moved it
+    void compact(void* cppInstance);
+
+    // Tracks instances of rbType, and types inherited from it, even if isEnabled is false
+    void track(const rb_data_type_t* rbType);
+    bool isTracked(const rb_data_type_t* rbType);
+
+    // Stops tracking rbType. Instances that are already tracked stay in the registry until
+    // they are freed.
+    void untrack(const rb_data_type_t* rbType);
+
   public:
     bool isEnabled = false;
 
   private:
-    VALUE lookup(void* cppInstance);
-    std::map<void*, VALUE> objectMap_;
+    // Open addressing hash table with linear probing. Empty slots have a nullptr key.
+    struct Entry
+    {
+      void* cppInstance = nullptr;
+      VALUE rubyInstance = Qnil;
+    };
+
+    VALUE lookup(void* cppInstance, const rb_data_type_t* rbType);
+    size_t slot(void* cppInstance) const;
+    void grow();
+
+    std::vector<Entry> entries_;
+    size_t size_ = 0;
+    std::vector<const rb_data_type_t*> trackedTypes_;
   };
 } // namespace Rice::detail
 
 #include "InstanceRegistry.ipp"
 
 #endif // Rice__detail__InstanceRegistry__hpp_
-
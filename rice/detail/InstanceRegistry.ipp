@@ -1,50 +1,176 @@
-#include <memory>
+#include <algorithm>
+#include <cstdint>
 
 namespace Rice::detail
 {
   template <typename T>
-  inline VALUE InstanceRegistry::lookup(T& cppInstance)
+  inline VALUE InstanceRegistry::lookup(T& cppInstance, const rb_data_type_t* rbType)
   {
-    return this->lookup((void*)&cppInstance);
+    return this->lookup((void*)&cppInstance, rbType);
   }
 
   template <typename T>
-  inline VALUE InstanceRegistry::lookup(T* cppInstance)
+  inline VALUE InstanceRegistry::lookup(T* cppInstance, const rb_data_type_t* rbType)
   {
-    return this->lookup((void*)cppInstance);
+    return this->lookup((void*)cppInstance, rbType);
   }
 
-  inline VALUE InstanceRegistry::lookup(void* cppInstance)
+  inline VALUE InstanceRegistry::lookup(void* cppInstance, const rb_data_type_t* rbType)
   {
-    if (!this->isEnabled)
+    if (this->size_ == 0 || (!this->isEnabled && !this->isTracked(rbType)))
       return Qnil;
 
-    auto it = this->objectMap_.find(cppInstance);
-    if (it != this->objectMap_.end())
+    size_t mask = this->entries_.size() - 1;
+    for (size_t i = this->slot(cppInstance); this->entries_[i].cppInstance; i = (i + 1) & mask)
     {
-      return it->second;
-    }
-    else
-    {
-      return Qnil;
+      if (this->entries_[i].cppInstance == cppInstance)
+      {
+        return this->entries_[i].rubyInstance;
+      }
     }
+
+    return Qnil;
   }
 
   inline void InstanceRegistry::add(void* cppInstance, VALUE rubyInstance)
   {
-    if (this->isEnabled)
+    if (!cppInstance || (!this->isEnabled && !this->isTracked(RTYPEDDATA_TYPE(rubyInstance))))
+      return;
+
+    // Keep the table at most half full so probe sequences stay short
+    if ((this->size_ + 1) * 2 > this->entries_.size())
+    {
+      this->grow();
+    }
+
+    size_t mask = this->entries_.size() - 1;
+    size_t i = this->slot(cppInstance);
+    while (this->entries_[i].cppInstance && this->entries_[i].cppInstance != cppInstance)
+    {
+      i = (i + 1) & mask;
+    }
+
+    if (!this->entries_[i].cppInstance)
     {
-      this->objectMap_[cppInstance] = rubyInstance;
+      this->entries_[i].cppInstance = cppInstance;
+      this->size_++;
     }
+    this->entries_[i].rubyInstance = rubyInstance;
   }
 
   inline void InstanceRegistry::remove(void* cppInstance)
   {
-    this->objectMap_.erase(cppInstance);
+    // This is called every time a wrapper is freed, so return as quickly as possible
+    // when nothing is tracked. Checking size_ instead of isEnabled makes sure entries
+    // added before tracking was turned off are still removed.
+    if (this->size_ == 0)
+      return;
+
+    size_t mask = this->entries_.size() - 1;
+    size_t i = this->slot(cppInstance);
+    while (this->entries_[i].cppInstance != cppInstance)
+    {
+      if (!this->entries_[i].cppInstance)
+        return;
+      i = (i + 1) & mask;
+    }
+
+    // Shift following entries back into the hole so lookups never stop early. An entry can
+    // move unless its home slot lies cyclically between the hole and its current position.
+    for (size_t j = (i + 1) & mask; this->entries_[j].cppInstance; j = (j + 1) & mask)
+    {
+      size_t home = this->slot(this->entries_[j].cppInstance);
+      bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+      if (!stays)
+      {
+        this->entries_[i] = this->entries_[j];
+        i = j;
+      }
+    }
+
+    this->entries_[i] = Entry();
+    this->size_--;
   }
 
   inline void InstanceRegistry::clear()
   {
-    this->objectMap_.clear();
+    this->entries_.clear();
+    this->size_ = 0;
+  }
+
+  inline void InstanceRegistry::compact(void* cppInstance)
+  {
+    if (this->size_ == 0)
+      return;
+
+    size_t mask = this->entries_.size() - 1;
+    for (size_t i = this->slot(cppInstance); this->entries_[i].cppInstance; i = (i + 1) & mask)
+    {
+      if (this->entries_[i].cppInstance == cppInstance)
+      {
+        this->entries_[i].rubyInstance = rb_gc_location(this->entries_[i].rubyInstance);
+        return;
+      }
+    }
+  }
+
+  inline void InstanceRegistry::track(const rb_data_type_t* rbType)
+  {
+    if (!this->isTracked(rbType))
+    {
+      this->trackedTypes_.push_back(rbType);
+    }
+  }
+
+  inline void InstanceRegistry::untrack(const rb_data_type_t* rbType)
+  {
+    auto iter = std::find(this->trackedTypes_.begin(), this->trackedTypes_.end(), rbType);
+    if (iter != this->trackedTypes_.end())
+    {
+      this->trackedTypes_.erase(iter);
+    }
+  }
+
+  inline bool InstanceRegistry::isTracked(const rb_data_type_t* rbType)
+  {
+    for (; rbType && !this->trackedTypes_.empty(); rbType = rbType->parent)
+    {
+      if (std::find(this->trackedTypes_.begin(), this->trackedTypes_.end(), rbType) != this->trackedTypes_.end())
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  inline size_t InstanceRegistry::slot(void* cppInstance) const
+  {
+    // Objects are aligned so the low bits of their addresses are mostly zero. Fibonacci
+    // hashing spreads the remaining bits over the whole word.
+    std::uintptr_t hash = reinterpret_cast<std::uintptr_t>(cppInstance) * static_cast<std::uintptr_t>(0x9E3779B97F4A7C15ull);
+    hash ^= hash >> (sizeof(std::uintptr_t) * 4);
+    return static_cast<size_t>(hash) & (this->entries_.size() - 1);
+  }
+
+  inline void InstanceRegistry::grow()
+  {
+    std::vector<Entry> existing(std::max<size_t>(this->entries_.size() * 2, 16));
+    std::swap(existing, this->entries_);
+    this->size_ = 0;
+
+    size_t mask = this->entries_.size() - 1;
+    for (const Entry& entry : existing)
+    {
+      if (entry.cppInstance)
+      {
+        size_t i = this->slot(entry.cppInstance);
+        while (this->entries_[i].cppInstance)
+        {
+          i = (i + 1) & mask;
+        }
+        this->entries_[i] = entry;
+        this->size_++;
+      }
+    }
   }
 } // namespace
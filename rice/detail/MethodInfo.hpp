@@ -1,9 +1,12 @@
 #ifndef Rice__MethodInfo__hpp_
 #define Rice__MethodInfo__hpp_
 
+#include <optional>
 #include <vector>
 #include "../Arg.hpp"
 #include "../Return.hpp"
+#include "../NoGVL.hpp"
+#include "../Overload.hpp"
 
 namespace Rice
 {
@@ -19,6 +22,13 @@ namespace Rice
       */
     std::string formatString();
 
+    /**
+      * Get the arity Ruby should enforce for this list of
+      * arguments. This is the number of arguments, or -1 if
+      * any of them are optional or keyword arguments.
+      */
+    int arity();
+
     /**
       * Add a defined Arg to this list of Arguments
       */
@@ -32,6 +42,12 @@ namespace Rice
 
     Return returnInfo;
 
+    // Set if the GVL should be released while the method runs
+    std::optional<NoGVL> noGVL;
+
+    // Set if the method should be added to the overloads of an existing method
+    bool overload = false;
+
   private:
     template <typename Arg_T>
     void processArg(const Arg_T& arg);
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <sstream>
 #include "from_ruby_defn.hpp"
 
@@ -30,6 +31,14 @@ namespace Rice
     {
       this->addArg(arg);
     }
+    else if constexpr (std::is_same_v<Arg_T, NoGVL>)
+    {
+      this->noGVL = arg;
+    }
+    else if constexpr (std::is_same_v<Arg_T, Overload>)
+    {
+      this->overload = true;
+    }
     else
     {
       this->returnInfo = arg;
@@ -61,6 +70,16 @@ namespace Rice
     return std::to_string(required) + std::to_string(optional);
   }
 
+  inline int MethodInfo::arity()
+  {
+    bool isVariable = std::any_of(this->args_.begin(), this->args_.end(), [](const Arg& arg)
+    {
+      return arg.hasDefaultValue() || arg.isKeyword();
+    });
+
+    return isVariable ? -1 : (int)this->args_.size();
+  }
+
   inline Arg& MethodInfo::arg(size_t pos)
   {
     return args_[pos];
@@ -0,0 +1,46 @@
+#ifndef Rice__detail__Native__hpp_
+#define Rice__detail__Native__hpp_
+
+#include <typeinfo>
+
+#include "ruby.hpp"
+
+namespace Rice::detail
+{
+  //! Base class of the objects Ruby calls into when it invokes a wrapped C++ function
+  /*! NativeFunction, NativeAttribute and NativeIterator all derive from Native. This
+   *  lets Rice keep pointers to them without knowing their template parameters, and
+   *  thus dispatch calls from Ruby to them through a single virtual function.
+   */
+  class Native
+  {
+  public:
+    Native() = default;
+    virtual ~Native() = default;
+
+    // Disallow copying/moving
+    Native(const Native&) = delete;
+    Native(Native&&) = delete;
+    void operator=(const Native&) = delete;
+    void operator=(Native&&) = delete;
+
+    // Invokes the wrapped C++ code with the arguments Ruby passed to the method
+    virtual VALUE operator()(int argc, VALUE* argv, VALUE self) = 0;
+
+    // Returns true if the arguments Ruby passed can be converted to the native's parameters.
+    // This is used to choose between natives overloaded under the same Ruby method.
+    virtual bool matches(int argc, VALUE* argv)
+    {
+      return true;
+    }
+
+    // Identifies the native's parameter types, or nullptr if the native cannot be overloaded.
+    // Natives with the same signature replace each other instead of being overloaded.
+    virtual const std::type_info* signature()
+    {
+      return nullptr;
+    }
+  };
+}
+
+#endif // Rice__detail__Native__hpp_
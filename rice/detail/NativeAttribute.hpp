@@ -2,6 +2,7 @@
 #define Rice__detail__Native_Attribute__hpp_
 
 #include "ruby.hpp"
+#include "Native.hpp"
 #include "../traits/attribute_traits.hpp"
 
 namespace Rice
@@ -16,7 +17,7 @@ namespace Rice
   namespace detail
   {
     template<typename Attribute_T>
-    class NativeAttribute
+    class NativeAttribute : public Native
     {
     public:
       using NativeAttribute_T = NativeAttribute<Attribute_T>;
@@ -29,12 +30,6 @@ namespace Rice
       // Register attribute getter/setter with Ruby
       static void define(VALUE klass, std::string name, Attribute_T attribute, AttrAccess access = AttrAccess::ReadWrite);
 
-      // Static member functions that Ruby calls to read an attribute value
-      static VALUE get(VALUE self);
-
-      // Static member functions that Ruby calls to write an attribute value
-      static VALUE set(VALUE self, VALUE value);
-
     public:
       // Disallow creating/copying/moving
       NativeAttribute() = delete;
@@ -43,6 +38,9 @@ namespace Rice
       void operator=(const NativeAttribute_T&) = delete;
       void operator=(NativeAttribute_T&&) = delete;
 
+      // Reads the attribute if Ruby passes no arguments, otherwise writes it
+      VALUE operator()(int argc, VALUE* argv, VALUE self) override;
+
     protected:
       NativeAttribute(VALUE klass, std::string name, Attribute_T attr, AttrAccess access = AttrAccess::ReadWrite);
 
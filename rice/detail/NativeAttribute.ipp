@@ -3,6 +3,7 @@
 
 #include "../traits/rice_traits.hpp"
 #include "NativeRegistry.hpp"
+#include "NativeSlots.hpp"
 #include "to_ruby_defn.hpp"
 #include "cpp_protect.hpp"
 
@@ -16,11 +17,10 @@ namespace Rice::detail
 
     if (access == AttrAccess::ReadWrite || access == AttrAccess::Read)
     {
-      // Tell Ruby to invoke the static method read to get the attribute value
-      detail::protect(rb_define_method, klass, name.c_str(), (RUBY_METHOD_FUNC)&NativeAttribute_T::get, 0);
-
-      // Add to native registry
-      detail::Registries::instance.natives.add(klass, Identifier(name).id(), native);
+      // Add to native registry and tell Ruby to invoke a trampoline bound to native to
+      // read the attribute value
+      RUBY_METHOD_FUNC trampoline = NativeSlots::claim<0>(klass, Identifier(name).id(), native);
+      detail::protect(rb_define_method, klass, name.c_str(), trampoline, 0);
     }
 
     if (access == AttrAccess::ReadWrite || access == AttrAccess::Write)
@@ -33,41 +33,31 @@ namespace Rice::detail
       // Define the write method name
       std::string setter = name + "=";
 
-      // Tell Ruby to invoke the static method write to get the attribute value
-      detail::protect(rb_define_method, klass, setter.c_str(), (RUBY_METHOD_FUNC)&NativeAttribute_T::set, 1);
-
-      // Add to native registry
-      detail::Registries::instance.natives.add(klass, Identifier(setter).id(), native);
+      // Add to native registry and tell Ruby to invoke a trampoline bound to native to
+      // write the attribute value
+      RUBY_METHOD_FUNC trampoline = NativeSlots::claim<1>(klass, Identifier(setter).id(), native);
+      detail::protect(rb_define_method, klass, setter.c_str(), trampoline, 1);
     }
   }
 
   template<typename Attribute_T>
-  inline VALUE NativeAttribute<Attribute_T>::get(VALUE self)
+  NativeAttribute<Attribute_T>::NativeAttribute(VALUE klass, std::string name,
+                                                             Attribute_T attribute, AttrAccess access)
+    : klass_(klass), name_(name), attribute_(attribute), access_(access)
   {
-    return cpp_protect([&]
-    {
-      using Native_Attr_T = NativeAttribute<Attribute_T>;
-      Native_Attr_T* attr = detail::Registries::instance.natives.lookup<Native_Attr_T*>();
-      return attr->read(self);
-    });
   }
 
   template<typename Attribute_T>
-  inline VALUE NativeAttribute<Attribute_T>::set(VALUE self, VALUE value)
+  inline VALUE NativeAttribute<Attribute_T>::operator()(int argc, VALUE* argv, VALUE self)
   {
-    return cpp_protect([&]
+    if (argc == 0)
     {
-      using Native_Attr_T = NativeAttribute<Attribute_T>;
-      Native_Attr_T* attr = detail::Registries::instance.natives.lookup<Native_Attr_T*>();
-      return attr->write(self, value);
-    });
-  }
-
-  template<typename Attribute_T>
-  NativeAttribute<Attribute_T>::NativeAttribute(VALUE klass, std::string name,
-                                                             Attribute_T attribute, AttrAccess access)
-    : klass_(klass), name_(name), attribute_(attribute), access_(access)
-  {
+      return this->read(self);
+    }
+    else
+    {
+      return this->write(self, argv[0]);
+    }
   }
 
   template<typename Attribute_T>
@@ -101,6 +91,9 @@ namespace Rice::detail
     {
       Receiver_T* nativeSelf = From_Ruby<Receiver_T*>().convert(self);
       nativeSelf->*attribute_ = From_Ruby<T_Unqualified>().convert(value);
+
+      // The attribute may hold a reference to value that a custom ruby_mark marks
+      RB_OBJ_WRITTEN(self, Qundef, value);
     }
     else if constexpr (!std::is_const_v<std::remove_pointer_t<T>>)
     {
@@ -1,23 +1,28 @@
 #ifndef Rice__detail__Native_Function__hpp_
 #define Rice__detail__Native_Function__hpp_
 
+#include <array>
+#include <vector>
+
 #include "ruby.hpp"
 #include "ExceptionHandler_defn.hpp"
 #include "MethodInfo.hpp"
+#include "Native.hpp"
+#include "NativeOverloads.hpp"
 #include "../traits/function_traits.hpp"
 #include "../traits/method_traits.hpp"
 #include "from_ruby.hpp"
+#include "without_gvl.hpp"
 
 namespace Rice::detail
 {
   //! The NativeFunction class calls C++ functions/methods/lambdas on behalf of Ruby
   /*! The NativeFunction class is an intermediate between Ruby and C++. Every method
    *  defined in Rice is associated with a NativeFuntion instance that is stored in
-   *  a unordered_map maintained by the MethodData class. The key is the Ruby class
-   *  and method.
+   *  the NativeRegistry. The key is the Ruby class and method.
    * 
-   *  When Ruby calls into C++ it invokes the static NativeFunction.call method. This
-   *  method then looks up the NativeFunction instance and calls its ->() operator.
+   *  When Ruby calls into C++ it invokes a trampoline function that is bound to the
+   *  NativeFunction instance (see NativeSlots) and calls its ->() operator.
    *
    *  The instance then converts each of the arguments passed from Ruby into their
    *  C++ equivalents. It then retrieves the C++ object (if there is one, Ruby could
@@ -43,7 +48,7 @@ namespace Rice::detail
    */
 
   template<typename Class_T, typename Function_T, bool IsMethod>
-  class NativeFunction
+  class NativeFunction : public Native
   {
   public:
     using NativeFunction_T = NativeFunction<Class_T, Function_T, IsMethod>;
@@ -58,9 +63,6 @@ namespace Rice::detail
     // Register function with Ruby
     static void define(VALUE klass, std::string method_name, Function_T function, MethodInfo* methodInfo);
 
-    // Static member function that Ruby calls
-    static VALUE call(int argc, VALUE* argv, VALUE self);
-
   public:
     // Disallow creating/copying/moving
     NativeFunction() = delete;
@@ -70,7 +72,11 @@ namespace Rice::detail
     void operator=(NativeFunction_T&&) = delete;
 
     // Invokes the wrapped function
-    VALUE operator()(int argc, VALUE* argv, VALUE self);
+    VALUE operator()(int argc, VALUE* argv, VALUE self) override;
+
+    // Overload resolution support
+    bool matches(int argc, VALUE* argv) override;
+    const std::type_info* signature() override;
 
   protected:
     NativeFunction(VALUE klass, std::string method_name, Function_T function, MethodInfo* methodInfo);
@@ -84,13 +90,25 @@ namespace Rice::detail
     From_Ruby_Args_Ts createFromRuby(std::index_sequence<I...>& indices);
 
     To_Ruby<Return_T> createToRuby();
+
+    // Can the Ruby values be converted to the function's parameters?
+    template<std::size_t...I>
+    bool isConvertible(int argc, VALUE* argv, std::index_sequence<I...>& indices);
+
+    template<std::size_t I>
+    bool isConvertible(VALUE value);
       
-    // Convert Ruby argv pointer to Ruby values
-    std::vector<VALUE> getRubyValues(int argc, VALUE* argv);
+    // Convert Ruby argv pointer to Ruby values. These are stored on the stack
+    // so they are visible to Ruby's garbage collector
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> getRubyValues(int argc, VALUE* argv);
 
-    // Convert Ruby values to C++ values
+    // Removes the keyword arguments hash from the end of argv and returns it (or Qnil)
+    VALUE getKeywords(int& argc, VALUE* argv);
+
+    // Convert Ruby values to C++ values. The converters keep the storage that reference and
+    // pointer parameters point to, so they must outlive the call.
     template<typename std::size_t...I>
-    Arg_Ts getNativeValues(std::vector<VALUE>& values, std::index_sequence<I...>& indices);
+    Arg_Ts getNativeValues(From_Ruby_Args_Ts& fromRubys, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& values, std::index_sequence<I...>& indices);
 
     // Figure out what self is
     Receiver_T getReceiver(VALUE self);
@@ -99,12 +117,21 @@ namespace Rice::detail
     [[noreturn]] void noWrapper(const VALUE klass, const std::string& wrapper);
 
     // Do we need to keep alive any arguments?
-    void checkKeepAlive(VALUE self, VALUE returnValue, std::vector<VALUE>& rubyValues);
+    void checkKeepAlive(VALUE self, VALUE returnValue, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues);
+
+    // Call the C++ function with the arguments in a tuple, releasing the GVL if requested
+    template<typename Tuple_T>
+    decltype(auto) callFunction(Tuple_T&& args);
 
-    // Call the underlying C++ function
+    // Convert the Ruby values and call the underlying C++ function
+    VALUE invoke(VALUE self, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues);
+    VALUE invokeNative(VALUE self, const Arg_Ts& nativeValues);
     VALUE invokeNativeFunction(const Arg_Ts& nativeArgs);
     VALUE invokeNativeMethod(VALUE self, const Arg_Ts& nativeArgs);
 
+    // Same as invoke, but locks the strings passed to Arg::lockString() parameters for the duration of the call
+    VALUE invokeWithStringLocks(VALUE self, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues);
+
   private:
     VALUE klass_;
     std::string method_name_;
@@ -112,6 +139,20 @@ namespace Rice::detail
     From_Ruby_Args_Ts fromRubys_;
     To_Ruby<Return_T> toRuby_;
     std::unique_ptr<MethodInfo> methodInfo_;
+
+    // Computed once at definition time so calls do not have to inspect methodInfo_
+    int requiredCount_ = 0;
+    int positionalCount_ = 0;
+    bool hasKeepAlive_ = false;
+    bool hasStringLock_ = false;
+
+    // Index in argv of each argument, or -1 for keyword arguments
+    std::array<int, std::tuple_size_v<Arg_Ts>> argvIndexes_{};
+
+    // Keyword argument ids, with the required keywords first, and the position of each one
+    std::vector<ID> keywordIds_;
+    std::vector<size_t> keywordPositions_;
+    int requiredKeywordCount_ = 0;
   };
 }
 #include "NativeFunction.ipp"
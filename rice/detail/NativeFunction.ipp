@@ -1,38 +1,48 @@
 #include <array>
 #include <algorithm>
+#include <memory>
 #include <stdexcept>
 #include <sstream>
 
 #include "cpp_protect.hpp"
 #include "to_ruby_defn.hpp"
 #include "NativeRegistry.hpp"
+#include "NativeSlots.hpp"
 
 namespace Rice::detail
 {
   template<typename Class_T, typename Function_T, bool IsMethod>
   void NativeFunction<Class_T, Function_T, IsMethod>::define(VALUE klass, std::string method_name, Function_T function, MethodInfo* methodInfo)
   {
-    // Tell Ruby to invoke the static method call on this class
-    detail::protect(rb_define_method, klass, method_name.c_str(), (RUBY_METHOD_FUNC)&NativeFunction_T::call, -1);
-
-    // Now create a NativeFunction instance and save it to the natives registry keyed on
+    // Create a NativeFunction instance and save it to the natives registry keyed on
     // Ruby klass and method id. There may be multiple NativeFunction instances
     // because the same C++ method could be mapped to multiple Ruby methods.
-    NativeFunction_T* native = new NativeFunction_T(klass, method_name, std::forward<Function_T>(function), methodInfo);
-    detail::Registries::instance.natives.add(klass, Identifier(method_name).id(), native);
-  }
+    std::unique_ptr<NativeFunction_T> native(new NativeFunction_T(klass, method_name, std::forward<Function_T>(function), methodInfo));
+    ID method_id = Identifier(method_name).id();
 
-  template<typename Class_T, typename Function_T, bool IsMethod>
-  VALUE NativeFunction<Class_T, Function_T, IsMethod>::call(int argc, VALUE* argv, VALUE self)
-  {
-    // Look up the native function based on the Ruby klass and method id
-    NativeFunction_T* nativeFunction = detail::Registries::instance.natives.lookup<NativeFunction_T*>();
+    // Functions marked as overloads are added to the overloads of the existing method
+    if (methodInfo->overload && NativeOverloads::define(klass, method_id, native.get()))
+    {
+      native.release();
+      return;
+    }
 
-    // Execute the function but make sure to catch any C++ exceptions!
-    return cpp_protect([&]
+    // If no argument has a default value then register the method with its exact arity.
+    // Ruby then checks the number of arguments itself and passes them straight through.
+    constexpr int argCount = (int)std::tuple_size_v<Arg_Ts>;
+    if constexpr (argCount <= 15)
     {
-      return nativeFunction->operator()(argc, argv, self);
-    });
+      if (methodInfo->arity() == argCount)
+      {
+        RUBY_METHOD_FUNC trampoline = NativeSlots::claim<argCount>(klass, method_id, native.release());
+        detail::protect(rb_define_method, klass, method_name.c_str(), trampoline, argCount);
+        return;
+      }
+    }
+
+    // Otherwise tell Ruby to pass argc/argv and scan them ourselves
+    RUBY_METHOD_FUNC trampoline = NativeSlots::claim<-1>(klass, method_id, native.release());
+    detail::protect(rb_define_method, klass, method_name.c_str(), trampoline, -1);
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
@@ -47,6 +57,52 @@ namespace Rice::detail
     this->fromRubys_ = this->createFromRuby(indices);
 
     this->toRuby_ = this->createToRuby();
+
+    // Precompute what each call needs to know about the arguments. Positional arguments
+    // are passed in order in argv, keyword arguments are looked up by their interned ids.
+    for (const Arg& arg : *this->methodInfo_)
+    {
+      if (arg.isKeyword())
+      {
+        this->argvIndexes_[arg.position] = -1;
+      }
+      else
+      {
+        this->argvIndexes_[arg.position] = this->positionalCount_++;
+        if (!arg.hasDefaultValue())
+        {
+          this->requiredCount_++;
+        }
+      }
+    }
+
+    // rb_get_kwargs expects the required keywords to come first
+    for (bool required : { true, false })
+    {
+      for (const Arg& arg : *this->methodInfo_)
+      {
+        if (arg.isKeyword() && arg.hasDefaultValue() != required)
+        {
+          this->keywordIds_.push_back(Identifier(arg.name).id());
+          this->keywordPositions_.push_back(arg.position);
+          if (required)
+          {
+            this->requiredKeywordCount_++;
+          }
+        }
+      }
+    }
+
+    this->hasKeepAlive_ = this->methodInfo_->returnInfo.isKeepAlive() ||
+      std::any_of(this->methodInfo_->begin(), this->methodInfo_->end(), [](const Arg& arg)
+      {
+        return arg.isKeepAlive();
+      });
+
+    this->hasStringLock_ = std::any_of(this->methodInfo_->begin(), this->methodInfo_->end(), [](const Arg& arg)
+      {
+        return arg.isLockString();
+      });
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
@@ -86,39 +142,128 @@ namespace Rice::detail
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
-  std::vector<VALUE> NativeFunction<Class_T, Function_T, IsMethod>::getRubyValues(int argc, VALUE* argv)
+  std::array<VALUE, std::tuple_size_v<typename NativeFunction<Class_T, Function_T, IsMethod>::Arg_Ts>> NativeFunction<Class_T, Function_T, IsMethod>::getRubyValues(int argc, VALUE* argv)
   {
-    // Setup a tuple for the leading rb_scan_args arguments
-    std::string scanFormat = this->methodInfo_->formatString();
-    std::tuple<int, VALUE*, const char*> rbScanArgs = std::forward_as_tuple(argc, argv, scanFormat.c_str());
-
-    // Create a vector to store the VALUEs that will be returned by rb_scan_args
-    std::vector<VALUE> rbScanValues(std::tuple_size_v<Arg_Ts>, Qnil);
-
-    // Convert the vector to an array so it can be concatenated to a tuple. As importantly
-    // fill it with pointers to rbScanValues
-    std::array<VALUE*, std::tuple_size_v<Arg_Ts>> rbScanValuePointers;
-    std::transform(rbScanValues.begin(), rbScanValues.end(), rbScanValuePointers.begin(),
-      [](VALUE& value)
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> result;
+    VALUE keywords = this->getKeywords(argc, argv);
+
+    // Methods registered with their exact arity have already been checked by Ruby. Otherwise
+    // this does the same check as rb_scan_args, but with counts computed at definition time
+    if (argc < this->requiredCount_ || argc > this->positionalCount_)
+    {
+      detail::protect(rb_error_arity, argc, this->requiredCount_, this->positionalCount_);
+    }
+
+    // Optional arguments that were not passed are nil, From_Ruby will then use their default values
+    if (this->keywordIds_.empty())
+    {
+      if constexpr (std::tuple_size_v<Arg_Ts> > 0)
       {
-        return &value;
-      });
+        std::copy(argv, argv + argc, result.begin());
+        std::fill(result.begin() + argc, result.end(), Qnil);
+      }
+      return result;
+    }
+
+    for (size_t i = 0; i < result.size(); i++)
+    {
+      int index = this->argvIndexes_[i];
+      result[i] = (index >= 0 && index < argc) ? argv[index] : Qnil;
+    }
+
+    // Extract the keyword arguments. Missing keywords are returned as Qundef and unknown
+    // keywords raise an ArgumentError.
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> keywordValues;
+    detail::protect(rb_get_kwargs, keywords, this->keywordIds_.data(), this->requiredKeywordCount_,
+      (int)this->keywordIds_.size() - this->requiredKeywordCount_, keywordValues.data());
+
+    for (size_t i = 0; i < this->keywordIds_.size(); i++)
+    {
+      result[this->keywordPositions_[i]] = (keywordValues[i] == Qundef) ? Qnil : keywordValues[i];
+    }
+
+    return result;
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  VALUE NativeFunction<Class_T, Function_T, IsMethod>::getKeywords(int& argc, VALUE* argv)
+  {
+    // Ruby passes keyword arguments as a hash after the positional arguments
+    if (!this->keywordIds_.empty() && argc > 0 && rb_keyword_given_p())
+    {
+      argc--;
+      return argv[argc];
+    }
+    return Qnil;
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  const std::type_info* NativeFunction<Class_T, Function_T, IsMethod>::signature()
+  {
+    // Overload resolution only looks at positional arguments, so functions with keyword
+    // arguments cannot be overloaded
+    return this->keywordIds_.empty() ? &typeid(Arg_Ts) : nullptr;
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  bool NativeFunction<Class_T, Function_T, IsMethod>::matches(int argc, VALUE* argv)
+  {
+    this->getKeywords(argc, argv);
+    if (argc < this->requiredCount_ || argc > this->positionalCount_)
+    {
+      return false;
+    }
+
+    auto indices = std::make_index_sequence<std::tuple_size_v<Arg_Ts>>{};
+    return this->isConvertible(argc, argv, indices);
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  template<std::size_t... I>
+  bool NativeFunction<Class_T, Function_T, IsMethod>::isConvertible(int argc, VALUE* argv, std::index_sequence<I...>& indices)
+  {
+    // Arguments that were not passed will use their default values
+    if constexpr (sizeof...(I) == 0)
+    {
+      return true;
+    }
+    else
+    {
+      return ((this->argvIndexes_[I] < 0 || this->argvIndexes_[I] >= argc || this->isConvertible<I>(argv[this->argvIndexes_[I]])) && ...);
+    }
+  }
 
-    // Combine the tuples and call rb_scan_args
-    std::apply(rb_scan_args, std::tuple_cat(rbScanArgs, rbScanValuePointers));
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  template<std::size_t I>
+  bool NativeFunction<Class_T, Function_T, IsMethod>::isConvertible(VALUE value)
+  {
+    const Arg& arg = this->methodInfo_->arg(I);
+    if (arg.isValue() || (value == Qnil && arg.hasDefaultValue()))
+    {
+      return true;
+    }
 
-    return rbScanValues;
+    // Converters that cannot check values accept anything and raise an exception if the conversion fails
+    using From_Ruby_T = std::tuple_element_t<I, From_Ruby_Args_Ts>;
+    if constexpr (has_is_convertible_v<From_Ruby_T>)
+    {
+      return std::get<I>(this->fromRubys_).is_convertible(value);
+    }
+    else
+    {
+      return true;
+    }
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
   template<std::size_t... I>
-  typename NativeFunction<Class_T, Function_T, IsMethod>::Arg_Ts NativeFunction<Class_T, Function_T, IsMethod>::getNativeValues(std::vector<VALUE>& values,
+  typename NativeFunction<Class_T, Function_T, IsMethod>::Arg_Ts NativeFunction<Class_T, Function_T, IsMethod>::getNativeValues(From_Ruby_Args_Ts& fromRubys, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& values,
      std::index_sequence<I...>& indices)
   {
     // Convert each Ruby value to its native value by calling the appropriate fromRuby instance.
     // Note that for fundamental types From_Ruby<Arg_Ts> will keep a copy of the native value
     // so it can be passed by reference or pointer to a native function.
-    return std::forward_as_tuple(std::get<I>(this->fromRubys_).convert(values[I])...);
+    return std::forward_as_tuple(std::get<I>(fromRubys).convert(values[I])...);
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
@@ -153,18 +298,108 @@ namespace Rice::detail
     }
   }
 
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  template<typename Tuple_T>
+  decltype(auto) NativeFunction<Class_T, Function_T, IsMethod>::callFunction(Tuple_T&& args)
+  {
+    if (this->methodInfo_->noGVL)
+    {
+      return detail::without_gvl(*this->methodInfo_->noGVL, this->function_, std::forward<Tuple_T>(args));
+    }
+    else
+    {
+      return std::apply(this->function_, std::forward<Tuple_T>(args));
+    }
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  VALUE NativeFunction<Class_T, Function_T, IsMethod>::invoke(VALUE self, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues)
+  {
+    auto indices = std::make_index_sequence<std::tuple_size_v<Arg_Ts>>{};
+
+    // Methods that release the GVL can be called again by another thread before they return,
+    // and that call's conversions would overwrite the values this call is using. Thus they
+    // convert into converters of their own.
+    if (this->methodInfo_->noGVL)
+    {
+      From_Ruby_Args_Ts fromRubys = this->createFromRuby(indices);
+      Arg_Ts nativeValues = this->getNativeValues(fromRubys, rubyValues, indices);
+      return this->invokeNative(self, nativeValues);
+    }
+    else
+    {
+      Arg_Ts nativeValues = this->getNativeValues(this->fromRubys_, rubyValues, indices);
+      return this->invokeNative(self, nativeValues);
+    }
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  VALUE NativeFunction<Class_T, Function_T, IsMethod>::invokeNative(VALUE self, const Arg_Ts& nativeValues)
+  {
+    if constexpr (std::is_same_v<Receiver_T, std::nullptr_t>)
+    {
+      return this->invokeNativeFunction(nativeValues);
+    }
+    else
+    {
+      return this->invokeNativeMethod(self, nativeValues);
+    }
+  }
+
+  template<typename Class_T, typename Function_T, bool IsMethod>
+  VALUE NativeFunction<Class_T, Function_T, IsMethod>::invokeWithStringLocks(VALUE self, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues)
+  {
+    // Strings are locked before they are converted, so that converting the other arguments
+    // cannot run Ruby code that modifies them either. The same string can be passed to more
+    // than one parameter but can only be locked once. Frozen strings cannot be modified anyway.
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> locked;
+    size_t lockedCount = 0;
+
+    // rb_str_unlocktmp only raises if the string is not locked
+    auto unlock = [&]()
+    {
+      for (size_t i = 0; i < lockedCount; i++)
+      {
+        detail::call_unprotected(rb_str_unlocktmp, locked[i]);
+      }
+    };
+
+    try
+    {
+      for (const Arg& arg : *this->methodInfo_)
+      {
+        VALUE value = rubyValues[arg.position];
+        if (arg.isLockString() && rb_type(value) == RUBY_T_STRING && !RB_OBJ_FROZEN(value) &&
+            std::find(locked.begin(), locked.begin() + lockedCount, value) == locked.begin() + lockedCount)
+        {
+          detail::protect(rb_str_locktmp, value);
+          locked[lockedCount++] = value;
+        }
+      }
+
+      VALUE result = this->invoke(self, rubyValues);
+      unlock();
+      return result;
+    }
+    catch (...)
+    {
+      unlock();
+      throw;
+    }
+  }
+
   template<typename Class_T, typename Function_T, bool IsMethod>
   VALUE NativeFunction<Class_T, Function_T, IsMethod>::invokeNativeFunction(const Arg_Ts& nativeArgs)
   {
     if constexpr (std::is_void_v<Return_T>)
     {
-      std::apply(this->function_, nativeArgs);
+      this->callFunction(nativeArgs);
       return Qnil;
     }
     else
     {
       // Call the native method and get the result
-      Return_T nativeResult = std::apply(this->function_, nativeArgs);
+      Return_T nativeResult = (Return_T)this->callFunction(nativeArgs);
 
       // Return the result
       return this->toRuby_.convert(nativeResult);
@@ -179,12 +414,12 @@ namespace Rice::detail
 
     if constexpr (std::is_void_v<Return_T>)
     {
-      std::apply(this->function_, selfAndNativeArgs);
+      this->callFunction(selfAndNativeArgs);
       return Qnil;
     }
     else
     {
-      Return_T nativeResult = (Return_T)std::apply(this->function_, selfAndNativeArgs);
+      Return_T nativeResult = (Return_T)this->callFunction(selfAndNativeArgs);
 
       // Special handling if the method returns self. If so we do not want
       // to create a new Ruby wrapper object and instead return self.
@@ -233,7 +468,7 @@ namespace Rice::detail
   }
 
   template<typename Class_T, typename Function_T, bool IsMethod>
-  void NativeFunction<Class_T, Function_T, IsMethod>::checkKeepAlive(VALUE self, VALUE returnValue, std::vector<VALUE>& rubyValues)
+  void NativeFunction<Class_T, Function_T, IsMethod>::checkKeepAlive(VALUE self, VALUE returnValue, std::array<VALUE, std::tuple_size_v<Arg_Ts>>& rubyValues)
   {
     // selfWrapper will be nullptr if this(self) is a builtin type and not an external(wrapped) type
     // it is highly unlikely that keepAlive is used in this case but we check anyway
@@ -248,7 +483,7 @@ namespace Rice::detail
         {
           noWrapper(self, "self");
         }
-        selfWrapper->addKeepAlive(rubyValues[arg.position]);
+        selfWrapper->addKeepAlive(self, rubyValues[arg.position]);
       }
     }
 
@@ -266,7 +501,7 @@ namespace Rice::detail
       {
         noWrapper(returnValue, "return");
       }
-      returnWrapper->addKeepAlive(self);
+      returnWrapper->addKeepAlive(returnValue, self);
     }
   }
 
@@ -274,26 +509,24 @@ namespace Rice::detail
   VALUE NativeFunction<Class_T, Function_T, IsMethod>::operator()(int argc, VALUE* argv, VALUE self)
   {
     // Get the ruby values
-    std::vector<VALUE> rubyValues = this->getRubyValues(argc, argv);
-
-    auto indices = std::make_index_sequence<std::tuple_size_v<Arg_Ts>>{};
-
-    // Convert the Ruby values to native values
-    Arg_Ts nativeValues = this->getNativeValues(rubyValues, indices);
+    std::array<VALUE, std::tuple_size_v<Arg_Ts>> rubyValues = this->getRubyValues(argc, argv);
 
     // Now call the native method
     VALUE result = Qnil;
-    if constexpr (std::is_same_v<Receiver_T, std::nullptr_t>)
+    if (this->hasStringLock_)
     {
-      result = this->invokeNativeFunction(nativeValues);
+      result = this->invokeWithStringLocks(self, rubyValues);
     }
     else
     {
-      result = this->invokeNativeMethod(self, nativeValues);
+      result = this->invoke(self, rubyValues);
     }
 
     // Check if any function arguments or return values need to have their lifetimes tied to the receiver
-    this->checkKeepAlive(self, result, rubyValues);
+    if (this->hasKeepAlive_)
+    {
+      this->checkKeepAlive(self, result, rubyValues);
+    }
 
     return result;
   }
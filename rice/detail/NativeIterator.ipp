@@ -4,32 +4,21 @@
 
 #include "cpp_protect.hpp"
 #include "NativeRegistry.hpp"
+#include "NativeSlots.hpp"
 
 namespace Rice::detail
 {
   template <typename T, typename Iterator_Func_T>
   inline void NativeIterator<T, Iterator_Func_T>::define(VALUE klass, std::string method_name, Iterator_Func_T begin, Iterator_Func_T end)
   {
-    // Tell Ruby to invoke the static method call on this class
-    detail::protect(rb_define_method, klass, method_name.c_str(), (RUBY_METHOD_FUNC)&NativeIterator_T::call, 0);
-
-    // Now create a NativeIterator instance and save it to the natives registry keyed on
+    // Create a NativeIterator instance and save it to the natives registry keyed on
     // Ruby klass and method id. There may be multiple NativeIterator instances
     // because the same C++ method could be mapped to multiple Ruby methods.
     NativeIterator_T* native = new NativeIterator_T(klass, method_name, begin, end);
-    detail::Registries::instance.natives.add(klass, Identifier(method_name).id(), native);
-  }
-
-  template<typename T, typename Iterator_Func_T>
-  inline VALUE NativeIterator<T, Iterator_Func_T>::call(VALUE self)
-  {
-    // Look up the native function based on the Ruby klass and method id
-    NativeIterator_T* nativeIterator = detail::Registries::instance.natives.lookup<NativeIterator_T*>();
 
-    return cpp_protect([&]
-    {
-      return nativeIterator->operator()(self);
-    });
+    // Tell Ruby to invoke a trampoline bound to the instance
+    RUBY_METHOD_FUNC trampoline = NativeSlots::claim<0>(klass, Identifier(method_name).id(), native);
+    detail::protect(rb_define_method, klass, method_name.c_str(), trampoline, 0);
   }
 
   template <typename T, typename Iterator_Func_T>
@@ -50,10 +39,14 @@ namespace Rice::detail
         // Get the iterator instance
         using Iter_T = NativeIterator<T, Iterator_Func_T>;
         // Class is easy
-        VALUE klass = protect(rb_class_of, recv);
+        VALUE klass = call_unprotected(rb_class_of, recv);
         // Read the method_id from an attribute we added to the enumerator instance
         ID method_id = protect(rb_ivar_get, eobj, rb_intern("rice_method"));
-        Iter_T* iterator = detail::Registries::instance.natives.lookup<Iter_T*>(klass, method_id);
+        Iter_T* iterator = dynamic_cast<Iter_T*>(detail::Registries::instance.natives.lookup(klass, method_id));
+        if (!iterator)
+        {
+          throw std::runtime_error("Could not find iterator for enumerator");
+        }
 
         // Get the wrapped C++ instance
         T* receiver = detail::From_Ruby<T*>().convert(recv);
@@ -78,6 +71,12 @@ namespace Rice::detail
     return enumerator;
   }
 
+  template<typename T, typename Iterator_Func_T>
+  inline VALUE NativeIterator<T, Iterator_Func_T>::operator()(int argc, VALUE* argv, VALUE self)
+  {
+    return this->operator()(self);
+  }
+
   template<typename T, typename Iterator_Func_T>
   inline VALUE NativeIterator<T, Iterator_Func_T>::operator()(VALUE self)
   {
@@ -0,0 +1,62 @@
+#ifndef Rice__detail__NativeOverloads__hpp_
+#define Rice__detail__NativeOverloads__hpp_
+
+#include <vector>
+
+#include "ruby.hpp"
+#include "Native.hpp"
+
+namespace Rice::detail
+{
+  //! Dispatches a Ruby method to one of several overloaded C++ functions
+  /*! When C++ functions with different parameter types are defined with the same Ruby
+   *  class and method name, and the later ones are marked with Overload(), they are
+   *  combined into a NativeOverloads instance which is then bound to the Ruby method. When Ruby calls the method, NativeOverloads invokes
+   *  the first function whose parameters accept the arguments, as determined by
+   *  From_Ruby<T>::is_convertible.
+   *
+   *  Resolving an overload has to check every argument against every candidate. Thus
+   *  each overload set also has an inline cache that remembers the function chosen for
+   *  the last combination of argument types. Repeated calls with the same argument
+   *  types, which is by far the most common case, skip resolution altogether.
+   */
+  class NativeOverloads : public Native
+  {
+  public:
+    //! Overloads the native already bound to klass and method_id with native
+    /*! Returns false if there is no native to overload, or the existing native has
+     *  the same parameters, in which case the caller should bind native itself.
+     *  Throws if either native cannot be overloaded.
+     */
+    static bool define(VALUE klass, ID method_id, Native* native);
+
+    VALUE operator()(int argc, VALUE* argv, VALUE self) override;
+
+  private:
+    NativeOverloads(VALUE klass, ID method_id);
+
+    // Adds native to the set, replacing any native with the same signature
+    void add(Native* native);
+
+    // Returns the native to call for these arguments or nullptr if there is none
+    Native* resolve(int argc, VALUE* argv);
+
+    // The part of a value's type that determines which overload is chosen
+    static VALUE typeKey(VALUE value);
+
+    [[noreturn]] void noMatch(int argc, VALUE* argv);
+
+  private:
+    VALUE klass_;
+    ID method_id_;
+    RUBY_METHOD_FUNC trampoline_ = nullptr;
+    std::vector<Native*> natives_;
+
+    // Inline cache - the native chosen for the last call and its argument types
+    Native* cached_ = nullptr;
+    std::vector<VALUE> cachedKeys_;
+  };
+}
+#include "NativeOverloads.ipp"
+
+#endif // Rice__detail__NativeOverloads__hpp_
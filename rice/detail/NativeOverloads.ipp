@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include "NativeRegistry.hpp"
+#include "NativeSlots.hpp"
+
+namespace Rice::detail
+{
+  inline bool NativeOverloads::define(VALUE klass, ID method_id, Native* native)
+  {
+    NativeRegistry& natives = Registries::instance.natives;
+    Native* existing = natives.lookup(klass, method_id);
+
+    // The first definition of a method has nothing to overload
+    if (!existing)
+    {
+      return false;
+    }
+
+    NativeOverloads* overloads = dynamic_cast<NativeOverloads*>(existing);
+    if (!native->signature() || (!overloads && !existing->signature()))
+    {
+      std::string message = std::string("Cannot overload ") + rb_class2name(klass) + "#" + rb_id2name(method_id) +
+        ". Functions with keyword arguments, attributes and iterators cannot be overloaded.";
+      throw std::runtime_error(message);
+    }
+
+    if (!overloads)
+    {
+      // A native with the same parameters replaces the existing one, just like redefining a method in Ruby
+      if (*existing->signature() == *native->signature())
+      {
+        return false;
+      }
+
+      overloads = new NativeOverloads(klass, method_id);
+      overloads->add(existing);
+      overloads->trampoline_ = NativeSlots::claim<-1>(klass, method_id, overloads);
+    }
+
+    overloads->add(native);
+
+    // Overloads can have different numbers of arguments so the Ruby method has variable arity
+    detail::protect(rb_define_method_id, klass, method_id, overloads->trampoline_, -1);
+    return true;
+  }
+
+  inline NativeOverloads::NativeOverloads(VALUE klass, ID method_id) : klass_(klass), method_id_(method_id)
+  {
+  }
+
+  inline void NativeOverloads::add(Native* native)
+  {
+    auto iter = std::find_if(this->natives_.begin(), this->natives_.end(), [native](Native* overload)
+    {
+      return *overload->signature() == *native->signature();
+    });
+
+    if (iter == this->natives_.end())
+    {
+      this->natives_.push_back(native);
+    }
+    else
+    {
+      *iter = native;
+    }
+
+    this->cached_ = nullptr;
+  }
+
+  inline VALUE NativeOverloads::typeKey(VALUE value)
+  {
+    // Wrapped C++ objects are identified by their data type, which unlike their class can
+    // never be garbage collected. Everything else is identified by its builtin type.
+    if (rb_type(value) == RUBY_T_DATA && RTYPEDDATA_P(value))
+    {
+      return (VALUE)RTYPEDDATA_TYPE(value);
+    }
+    return (VALUE)rb_type(value);
+  }
+
+  inline Native* NativeOverloads::resolve(int argc, VALUE* argv)
+  {
+    // Check the inline cache first
+    bool hit = this->cached_ && argc == (int)this->cachedKeys_.size();
+    for (int i = 0; hit && i < argc; i++)
+    {
+      hit = this->cachedKeys_[i] == typeKey(argv[i]);
+    }
+
+    if (hit)
+    {
+      return this->cached_;
+    }
+
+    // Find the first native that accepts the arguments
+    auto iter = std::find_if(this->natives_.begin(), this->natives_.end(), [argc, argv](Native* native)
+    {
+      return native->matches(argc, argv);
+    });
+
+    if (iter == this->natives_.end())
+    {
+      return nullptr;
+    }
+
+    this->cached_ = *iter;
+    this->cachedKeys_.resize(argc);
+    std::transform(argv, argv + argc, this->cachedKeys_.begin(), typeKey);
+
+    return this->cached_;
+  }
+
+  inline void NativeOverloads::noMatch(int argc, VALUE* argv)
+  {
+    std::ostringstream types;
+    for (int i = 0; i < argc; i++)
+    {
+      types << (i > 0 ? ", " : "") << rb_obj_classname(argv[i]);
+    }
+
+    throw Exception(rb_eArgError, "No overload of %s#%s accepts the arguments (%s)",
+      rb_class2name(this->klass_), rb_id2name(this->method_id_), types.str().c_str());
+  }
+
+  inline VALUE NativeOverloads::operator()(int argc, VALUE* argv, VALUE self)
+  {
+    Native* native = this->resolve(argc, argv);
+    if (!native)
+    {
+      this->noMatch(argc, argv);
+    }
+    return (*native)(argc, argv, self);
+  }
+}
@@ -1,31 +1,47 @@
 #ifndef Rice__detail__NativeRegistry__hpp
 #define Rice__detail__NativeRegistry__hpp
 
-#include <unordered_map>
-#include <any>
+#include <vector>
 
 #include "ruby.hpp"
+#include "Native.hpp"
 
 namespace Rice::detail
 {
+  /* The NativeRegistry maps Ruby classes and method ids to the Native instances that
+     implement them. It is an open addressing hash table (with linear probing) that
+     is keyed on the full klass and method id pair so that two different methods can
+     never be confused with each other. */
   class NativeRegistry
   {
   public:
     // Add a new native callable object keyed by Ruby class and method_id
-    void add(VALUE klass, ID method_id, std::any callable);
+    void add(VALUE klass, ID method_id, Native* native);
 
-    // Returns the Rice data for the currently active Ruby method
-    template <typename Return_T>
-    Return_T lookup();
+    // Returns the Native for the currently active Ruby method
+    Native* lookup();
 
-    template <typename Return_T>
-    Return_T lookup(VALUE klass, ID method_id);
+    // Returns the Native for the Ruby class and method_id or nullptr if there is none
+    Native* lookup(VALUE klass, ID method_id);
 
   private:
-    size_t key(VALUE klass, ID method_id);
-    std::unordered_map<size_t, std::any> natives_ = {};
+    struct Entry
+    {
+      VALUE klass = 0;
+      ID method_id = 0;
+      Native* native = nullptr;
+    };
+
+    VALUE resolve(VALUE klass);
+    size_t hash(VALUE klass, ID method_id);
+    Entry& find(VALUE klass, ID method_id);
+    void grow();
+
+  private:
+    std::vector<Entry> entries_ = std::vector<Entry>(64);
+    size_t count_ = 0;
   };
 } 
 #include "NativeRegistry.ipp"
 
-#endif // Rice__detail__NativeRegistry__hpp
\ No newline at end of file
+#endif // Rice__detail__NativeRegistry__hpp
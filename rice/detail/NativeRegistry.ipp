@@ -1,4 +1,3 @@
-
 // Ruby 2.7 now includes a similarly named macro that uses templates to
 // pick the right overload for the underlying function. That doesn't work
 // for our cases because we are using this method dynamically and get a
@@ -10,27 +9,82 @@
 
 namespace Rice::detail
 {
-  // Effective Java (2nd edition)
-  // https://stackoverflow.com/a/2634715
-  inline size_t NativeRegistry::key(VALUE klass, ID id)
+  inline VALUE NativeRegistry::resolve(VALUE klass)
   {
+    // Methods defined in modules are invoked on the module's include class
     if (rb_type(klass) == T_ICLASS)
     {
-      klass = detail::protect(rb_class_of, klass);
+      klass = detail::call_unprotected(rb_class_of, klass);
     }
+    return klass;
+  }
+
+  inline size_t NativeRegistry::hash(VALUE klass, ID method_id)
+  {
+    // Mix both halves of the key (the finalizer from MurmurHash3) so that
+    // nearby classes and ids do not end up in nearby buckets
+    uint64_t result = (uint64_t)klass ^ ((uint64_t)method_id * 0x9e3779b97f4a7c15ULL);
+    result ^= result >> 33;
+    result *= 0xff51afd7ed558ccdULL;
+    result ^= result >> 33;
+    result *= 0xc4ceb9fe1a85ec53ULL;
+    result ^= result >> 33;
+    return (size_t)result;
+  }
+
+  inline NativeRegistry::Entry& NativeRegistry::find(VALUE klass, ID method_id)
+  {
+    // The table size is a power of two and is never full, so the probe
+    // will end at either the matching entry or an empty one
+    size_t mask = this->entries_.size() - 1;
+    size_t index = this->hash(klass, method_id) & mask;
 
-    uint32_t prime = 53;
-    return (prime + klass) * prime + id;
+    while (true)
+    {
+      Entry& entry = this->entries_[index];
+      if (entry.native == nullptr || (entry.klass == klass && entry.method_id == method_id))
+      {
+        return entry;
+      }
+      index = (index + 1) & mask;
+    }
   }
 
-  inline void NativeRegistry::add(VALUE klass, ID method_id, std::any callable)
+  inline void NativeRegistry::grow()
   {
-    // Now store data about it
-    this->natives_[key(klass, method_id)] = callable;
+    std::vector<Entry> entries(this->entries_.size() * 2);
+    std::swap(this->entries_, entries);
+
+    for (const Entry& entry : entries)
+    {
+      if (entry.native)
+      {
+        this->find(entry.klass, entry.method_id) = entry;
+      }
+    }
   }
 
-  template <typename Return_T>
-  inline Return_T NativeRegistry::lookup()
+  inline void NativeRegistry::add(VALUE klass, ID method_id, Native* native)
+  {
+    // Keep the load factor under 50% so probes stay short
+    if ((this->count_ + 1) * 2 > this->entries_.size())
+    {
+      this->grow();
+    }
+
+    klass = this->resolve(klass);
+    Entry& entry = this->find(klass, method_id);
+    if (entry.native == nullptr)
+    {
+      this->count_++;
+    }
+
+    entry.klass = klass;
+    entry.method_id = method_id;
+    entry.native = native;
+  }
+
+  inline Native* NativeRegistry::lookup()
   {
     ID method_id;
     VALUE klass;
@@ -39,19 +93,18 @@ namespace Rice::detail
       rb_raise(rb_eRuntimeError, "Cannot get method id and class for function");
     }
 
-    return this->lookup<Return_T>(klass, method_id);
-  }
-
-  template <typename Return_T>
-  inline Return_T NativeRegistry::lookup(VALUE klass, ID method_id)
-  {
-    auto iter = this->natives_.find(key(klass, method_id));
-    if (iter == this->natives_.end())
+    Native* native = this->lookup(klass, method_id);
+    if (native == nullptr)
     {
       rb_raise(rb_eRuntimeError, "Could not find data for klass and method id");
     }
 
-    std::any data = iter->second;
-    return std::any_cast<Return_T>(data);
+    return native;
+  }
+
+  inline Native* NativeRegistry::lookup(VALUE klass, ID method_id)
+  {
+    klass = this->resolve(klass);
+    return this->find(klass, method_id).native;
   }
 }
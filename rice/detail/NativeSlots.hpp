@@ -0,0 +1,81 @@
+#ifndef Rice__detail__NativeSlots__hpp_
+#define Rice__detail__NativeSlots__hpp_
+
+#include <array>
+#include <utility>
+
+#include "ruby.hpp"
+#include "Native.hpp"
+
+// The number of Ruby methods that can be dispatched directly to their Native. Methods
+// defined after all the slots are claimed fall back to a NativeRegistry lookup. Each slot
+// adds one trampoline per arity used to every translation unit, so larger values make
+// compiling and linking noticeably slower.
+#ifndef RICE_NATIVE_SLOTS
+#define RICE_NATIVE_SLOTS 128
+#endif
+
+namespace Rice::detail
+{
+  /* The Ruby C API does not provide a way to associate data with a method. Thus when Ruby
+     calls a C function it has no way to tell the function which Native to invoke, and the
+     function instead has to look up the current method's class and id and then find the
+     Native in the NativeRegistry.
+
+     NativeSlots avoids that lookup. It generates a pool of trampoline functions at compile
+     time, one per slot, and each trampoline calls the Native stored in its slot. Binding a
+     Native to a Ruby method claims a free slot and registers that slot's trampoline with Ruby,
+     so calling the method costs an array load plus a virtual call. Once all the slots are
+     claimed, methods are bound to an extra trampoline that looks up the Native in the
+     NativeRegistry instead. Slots are never reused. Redefining a method claims a new slot
+     and the old slot keeps its Native, so aliases of the old method still call it with the
+     arity its trampoline was built for.
+
+     Trampolines are generated for both variable (-1) and fixed (0 to 15) arities so they can
+     match the signature Ruby expects for the method. */
+  class NativeSlots
+  {
+  public:
+    //! Registers native for klass and method_id, claims a slot for it and returns the
+    //! trampoline Ruby should call for it
+    template<int Arity>
+    static RUBY_METHOD_FUNC claim(VALUE klass, ID method_id, Native* native);
+
+  private:
+    template<std::size_t>
+    using Value_T = VALUE;
+
+    // Calls native and translates any C++ exceptions into Ruby exceptions. Keeping this out
+    // of the trampolines keeps them tiny, which matters since there are so many of them.
+    static VALUE invoke(Native* native, int argc, VALUE* argv, VALUE self);
+
+    // Returns the Native in a slot. The slot after the last one is not backed by the
+    // slots array and instead looks up the Native in the NativeRegistry.
+    template<std::size_t Slot>
+    static Native* native();
+
+    // Trampoline for methods with variable arity
+    template<std::size_t Slot>
+    static VALUE call(int argc, VALUE* argv, VALUE self);
+
+    // Trampoline for methods with fixed arity
+    template<std::size_t Slot, std::size_t...I>
+    static VALUE callFixed(VALUE self, Value_T<I>...values);
+
+    template<int Arity, std::size_t Slot>
+    static RUBY_METHOD_FUNC makeTrampoline();
+
+    template<std::size_t Slot, std::size_t...I>
+    static RUBY_METHOD_FUNC makeTrampolineFixed(std::index_sequence<I...>& indices);
+
+    template<int Arity, std::size_t...Slot>
+    static RUBY_METHOD_FUNC trampoline(std::size_t slot, std::index_sequence<Slot...>& slots);
+
+  private:
+    static inline std::array<Native*, RICE_NATIVE_SLOTS> natives_{};
+    static inline std::size_t count_ = 0;
+  };
+}
+#include "NativeSlots.ipp"
+
+#endif // Rice__detail__NativeSlots__hpp_
@@ -0,0 +1,86 @@
+#include "cpp_protect.hpp"
+
+namespace Rice::detail
+{
+  template<int Arity>
+  inline RUBY_METHOD_FUNC NativeSlots::claim(VALUE klass, ID method_id, Native* native)
+  {
+    static_assert(Arity >= -1 && Arity <= 15, "Ruby methods must have an arity between -1 and 15");
+
+    // If all slots are claimed use the extra slot that looks up natives in the registry
+    std::size_t slot = RICE_NATIVE_SLOTS;
+
+    if (count_ < natives_.size())
+    {
+      slot = count_++;
+      natives_[slot] = native;
+    }
+
+    Registries::instance.natives.add(klass, method_id, native);
+
+    auto slots = std::make_index_sequence<RICE_NATIVE_SLOTS + 1>{};
+    return trampoline<Arity>(slot, slots);
+  }
+
+  template<std::size_t Slot>
+  inline Native* NativeSlots::native()
+  {
+    if constexpr (Slot < RICE_NATIVE_SLOTS)
+    {
+      return natives_[Slot];
+    }
+    else
+    {
+      return Registries::instance.natives.lookup();
+    }
+  }
+
+  inline VALUE NativeSlots::invoke(Native* native, int argc, VALUE* argv, VALUE self)
+  {
+    return cpp_protect([&]
+    {
+      return native->operator()(argc, argv, self);
+    });
+  }
+
+  template<std::size_t Slot>
+  inline VALUE NativeSlots::call(int argc, VALUE* argv, VALUE self)
+  {
+    return invoke(native<Slot>(), argc, argv, self);
+  }
+
+  template<std::size_t Slot, std::size_t...I>
+  inline VALUE NativeSlots::callFixed(VALUE self, Value_T<I>...values)
+  {
+    std::array<VALUE, sizeof...(I)> argv = { values... };
+    return invoke(native<Slot>(), (int)argv.size(), argv.data(), self);
+  }
+
+  template<int Arity, std::size_t Slot>
+  inline RUBY_METHOD_FUNC NativeSlots::makeTrampoline()
+  {
+    if constexpr (Arity < 0)
+    {
+      return (RUBY_METHOD_FUNC)&NativeSlots::call<Slot>;
+    }
+    else
+    {
+      auto indices = std::make_index_sequence<Arity>{};
+      return makeTrampolineFixed<Slot>(indices);
+    }
+  }
+
+  template<std::size_t Slot, std::size_t...I>
+  inline RUBY_METHOD_FUNC NativeSlots::makeTrampolineFixed(std::index_sequence<I...>& indices)
+  {
+    return (RUBY_METHOD_FUNC)&NativeSlots::callFixed<Slot, I...>;
+  }
+
+  template<int Arity, std::size_t...Slot>
+  inline RUBY_METHOD_FUNC NativeSlots::trampoline(std::size_t slot, std::index_sequence<Slot...>& slots)
+  {
+    // One trampoline per slot, only generated for the arities that are actually used
+    static const RUBY_METHOD_FUNC trampolines[] = { makeTrampoline<Arity, Slot>()... };
+    return trampolines[slot];
+  }
+}
@@ -3,6 +3,8 @@
 
 #include "ruby.hpp"
 
+#include <optional>
+
 namespace Rice::detail
 {
   /* This is functor class that wraps calls to a Ruby C API method. It is needed because
@@ -22,12 +24,41 @@ namespace Rice::detail
     Return_T operator()();
 
   private:
+    // The result of the call is stored in the functor itself, which rb_protect passes
+    // through to the callback as its VALUE argument. Return values cannot be passed back
+    // as a VALUE because that is not lossless - for example a double with value of -1.0
+    // does not roundtrip. References are stored as pointers.
+    using Result_T = std::conditional_t<std::is_void_v<Return_T>, std::nullptr_t,
+                       std::conditional_t<std::is_reference_v<Return_T>, std::remove_reference_t<Return_T>*, Return_T>>;
+
     Function_T func_;
     std::tuple<Arg_Ts...> args_;
+    std::optional<Result_T> result_;
   };
 
   template<typename Function_T, typename ...Arg_Ts>
-  auto protect(Function_T func, Arg_Ts...args);
+  decltype(auto) protect(Function_T func, Arg_Ts...args);
+
+  /* Calls a Ruby C API function directly, without the setjmp and bookkeeping done by
+     protect. This is only safe for functions that cannot raise a Ruby exception (or
+     otherwise longjmp), because that would unwind through C++ frames without running
+     destructors. Functions that qualify include:
+
+       - Accessors that never allocate or check their arguments - rb_ary_entry,
+         rb_array_len, rb_class_of, rb_obj_class
+       - Type checks that are known to pass, such as rb_check_type on a value whose
+         type has already been checked
+
+     Note that functions which allocate Ruby objects, such as rb_str_new, can raise
+     NoMemoryError and thus should still be protected. That includes functions that only
+     allocate sometimes, such as rb_obj_classname for anonymous classes and rb_id2sym
+     for dynamic IDs. */
+  template<typename Function_T, typename ...Arg_Ts>
+  auto call_unprotected(Function_T func, Arg_Ts...args);
+
+  // Raises a TypeError if value is not a String. Only pays for protect when
+  // rb_check_type is going to raise an exception.
+  void checkString(VALUE value);
 }
 #include "RubyFunction.ipp"
 
@@ -1,8 +1,6 @@
 #include "Jump_Tag.hpp"
 #include "../Exception_defn.hpp"
 
-#include <any>
-
 namespace Rice::detail
 {
   template<typename Function_T, typename...Arg_Ts>
@@ -17,28 +15,24 @@ namespace Rice::detail
     const int TAG_RAISE = 0x6; // From Ruby header files
     int state = 0;
 
-    // Setup a thread local variable to capture the result of the Ruby function call.
-    // We use thread_local because the lambda has to be captureless so it can
-    // be converted to a function pointer callable by C.
-    // The thread local variable avoids having to cast the result to VALUE and then 
-    // back again to Return_T. The problem with that is the translation is not lossless
-    // in some cases - for example a double with value of -1.0 does not roundrip.
-    // 
-    thread_local std::any result;
-
-    // Callback that will invoke the Ruby function
+    // Callback that will invoke the Ruby function. It has to be captureless so it can be
+    // converted to a function pointer callable by C, so the functor is passed as its argument.
     using Functor_T = RubyFunction<Function_T, Arg_Ts...>;
     auto callback = [](VALUE value) -> VALUE
     {
       Functor_T* functor = (Functor_T*)value;
 
-      if constexpr (std::is_same_v<Return_T, void>)
+      if constexpr (std::is_void_v<Return_T>)
       {
         std::apply(functor->func_, functor->args_);
       }
+      else if constexpr (std::is_reference_v<Return_T>)
+      {
+        functor->result_.emplace(&std::apply(functor->func_, functor->args_));
+      }
       else
       {
-        result = std::apply(functor->func_, functor->args_);
+        functor->result_.emplace(std::apply(functor->func_, functor->args_));
       }
 
       return Qnil;
@@ -52,7 +46,14 @@ namespace Rice::detail
     {
       if constexpr (!std::is_same_v<Return_T, void>)
       {
-        return std::any_cast<Return_T>(result);
+        if constexpr (std::is_reference_v<Return_T>)
+        {
+          return **this->result_;
+        }
+        else
+        {
+          return std::move(*this->result_);
+        }
       }
     }
     else
@@ -72,9 +73,23 @@ namespace Rice::detail
     
   // Create a functor for calling a Ruby function and define some aliases for readability.
   template<typename Function_T, typename ...Arg_Ts>
-  auto protect(Function_T func, Arg_Ts...args)
+  decltype(auto) protect(Function_T func, Arg_Ts...args)
   {
     auto rubyFunction = RubyFunction<Function_T, Arg_Ts...>(func, std::forward<Arg_Ts>(args)...);
     return rubyFunction();
   }
+
+  template<typename Function_T, typename ...Arg_Ts>
+  inline auto call_unprotected(Function_T func, Arg_Ts...args)
+  {
+    return func(args...);
+  }
+
+  inline void checkString(VALUE value)
+  {
+    if (rb_type(value) != RUBY_T_STRING)
+    {
+      detail::protect(rb_check_type, value, (int)T_STRING);
+    }
+  }
 }
\ No newline at end of file
@@ -1,10 +1,12 @@
 #ifndef Rice__TypeRegistry__hpp_
 #define Rice__TypeRegistry__hpp_
 
+#include <iterator>
 #include <optional>
 #include <string>
 #include <typeindex>
 #include <typeinfo>
+#include <type_traits>
 #include <unordered_map>
 
 #include "ruby.hpp"
@@ -37,8 +39,24 @@ namespace Rice::detail
     std::pair<VALUE, rb_data_type_t*> figureType(const T& object);
 
   private:
+    // Remembers the result of figureType for one C++ type so that returning an object
+    // does not probe registry_ every time. Entries are only valid for the registry and
+    // generation they were looked up in - add and remove bump the generation.
+    template <size_t N>
+    struct TypeCache
+    {
+      const TypeRegistry* registry = nullptr;
+      size_t generation = 0;
+      size_t next = 0;
+      const std::type_info* typeInfos[N] = {};
+      std::pair<VALUE, rb_data_type_t*> types[N] = {};
+    };
+
     std::optional<std::pair<VALUE, rb_data_type_t*>> lookup(const std::type_info& typeInfo);
+    std::pair<VALUE, rb_data_type_t*> resolve(const std::type_info& objectType, const std::type_info& staticType);
+
     std::unordered_map<std::type_index, std::pair<VALUE, rb_data_type_t*>> registry_{};
+    size_t generation_ = 1;
   };
 }
 
@@ -11,6 +11,7 @@ namespace Rice::detail
   {
     std::type_index key(typeid(T));
     registry_[key] = std::pair(klass, rbType);
+    this->generation_++;
   }
 
   template <typename T>
@@ -18,6 +19,7 @@ namespace Rice::detail
   {
     std::type_index key(typeid(T));
     registry_.erase(key);
+    this->generation_++;
   }
 
   template <typename T>
@@ -54,11 +56,10 @@ namespace Rice::detail
     }
   }
 
-  template <typename T>
-  inline std::pair<VALUE, rb_data_type_t*> TypeRegistry::figureType(const T& object)
+  inline std::pair<VALUE, rb_data_type_t*> TypeRegistry::resolve(const std::type_info& objectType, const std::type_info& staticType)
   {
     // First check and see if the actual type of the object is registered
-    std::optional<std::pair<VALUE, rb_data_type_t*>> result = lookup(typeid(object));
+    std::optional<std::pair<VALUE, rb_data_type_t*>> result = lookup(objectType);
 
     if (result)
     {
@@ -68,14 +69,62 @@ namespace Rice::detail
     // If not, then we are willing to accept an ancestor class specified by T. This is needed
     // to support Directors. Classes inherited from Directors are never actually registered
     // with Rice - and what we really want it to return the C++ class they inherit from.
-    result = lookup(typeid(T));
+    result = lookup(staticType);
     if (result)
     {
       return result.value();
     }
 
     // Give up!
-    std::string message = "Type " + typeName(typeid(object)) + " is not registered";
+    std::string message = "Type " + typeName(objectType) + " is not registered";
     throw std::runtime_error(message.c_str());
   }
+
+  template <typename T>
+  inline std::pair<VALUE, rb_data_type_t*> TypeRegistry::figureType(const T& object)
+  {
+    if constexpr (!std::is_polymorphic_v<T> || std::is_final_v<T>)
+    {
+      // The object's type has to be T so there is only one answer to remember
+      static TypeCache<1> cache;
+
+      if (cache.registry != this || cache.generation != this->generation_)
+      {
+        cache.types[0] = resolve(typeid(T), typeid(T));
+        cache.registry = this;
+        cache.generation = this->generation_;
+      }
+
+      return cache.types[0];
+    }
+    else
+    {
+      // The object could be any class derived from T. Remember the last few types seen,
+      // keyed on their type_info address. Distinct addresses can refer to the same type
+      // across shared libraries, which just costs an extra cache entry.
+      static TypeCache<4> cache;
+      const std::type_info& objectType = typeid(object);
+
+      if (cache.registry != this || cache.generation != this->generation_)
+      {
+        cache = TypeCache<4>();
+        cache.registry = this;
+        cache.generation = this->generation_;
+      }
+
+      for (size_t i = 0; i < std::size(cache.typeInfos); i++)
+      {
+        if (cache.typeInfos[i] == &objectType)
+        {
+          return cache.types[i];
+        }
+      }
+
+      std::pair<VALUE, rb_data_type_t*> result = resolve(objectType, typeid(T));
+      size_t slot = cache.next++ % std::size(cache.typeInfos);
+      cache.typeInfos[slot] = &objectType;
+      cache.types[slot] = result;
+      return result;
+    }
+  }
 }
\ No newline at end of file
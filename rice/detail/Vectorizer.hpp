@@ -0,0 +1,54 @@
+#ifndef Rice__detail__Vectorizer__hpp_
+#define Rice__detail__Vectorizer__hpp_
+
+#include <tuple>
+#include <type_traits>
+
+#include "ruby.hpp"
+#include "../traits/method_traits.hpp"
+#include "../traits/rice_traits.hpp"
+
+namespace Rice
+{
+  template<typename T>
+  class Data_Type;
+}
+
+namespace Rice::detail
+{
+  //! Applies a scalar C++ function to every element of a Ruby Array or wrapped std::vector
+  /*! Calling a scalar function once per element from a Ruby loop pays the full cost of
+   *  a Ruby to C++ method call for every element. Vectorizer instead creates a function
+   *  that takes the whole collection and loops over it in C++. The argument and return
+   *  value converters are created once per call, and the result Array is sized up front.
+   *
+   *  @tparam Function_T - The scalar function. Not counting self, it must take exactly one argument.
+   *  @tparam IsMethod - Whether the function has a self parameter (see NativeFunction)
+   */
+  template<typename Function_T, bool IsMethod>
+  class Vectorizer
+  {
+  public:
+    using Arg_Ts = typename method_traits<Function_T, IsMethod>::Arg_Ts;
+    using Receiver_T = typename method_traits<Function_T, IsMethod>::Class_T;
+    using Return_T = remove_cv_recursive_t<typename method_traits<Function_T, IsMethod>::Return_T>;
+
+    static_assert(std::tuple_size_v<Arg_Ts> == 1, "Vectorized functions must take exactly one argument");
+    using Arg_T = remove_cv_recursive_t<std::tuple_element_t<0, Arg_Ts>>;
+    using Element_T = intrinsic_type<Arg_T>;
+
+    //! Returns a function that takes a Ruby Array or wrapped std::vector (and self if IsMethod)
+    //! and returns a Ruby Array with the result of calling func on each element.
+    static auto vectorize(Function_T func);
+
+  private:
+    template<typename Call_T>
+    static VALUE map(VALUE values, Call_T&& call);
+
+    template<typename Call_T, typename Value_T>
+    static VALUE invoke(Call_T& call, To_Ruby<Return_T>& toRuby, Value_T&& value);
+  };
+}
+#include "Vectorizer.ipp"
+
+#endif // Rice__detail__Vectorizer__hpp_
@@ -0,0 +1,103 @@
+#include <functional>
+#include <vector>
+
+#include "RubyFunction.hpp"
+#include "Type.hpp"
+#include "Wrapper.hpp"
+
+namespace Rice::detail
+{
+  template<typename Function_T, bool IsMethod>
+  inline auto Vectorizer<Function_T, IsMethod>::vectorize(Function_T func)
+  {
+    // Make sure the element and result types have been previously seen by Rice
+    verifyType<Return_T>();
+    verifyTypes<Arg_Ts>();
+
+    if constexpr (IsMethod)
+    {
+      return [func](Receiver_T self, VALUE values) -> VALUE
+      {
+        return map(values, [&func, &self](auto&& value) -> decltype(auto)
+        {
+          return std::invoke(func, self, std::forward<decltype(value)>(value));
+        });
+      };
+    }
+    else
+    {
+      return [func](VALUE values) -> VALUE
+      {
+        return map(values, [&func](auto&& value) -> decltype(auto)
+        {
+          return std::invoke(func, std::forward<decltype(value)>(value));
+        });
+      };
+    }
+  }
+
+  template<typename Function_T, bool IsMethod>
+  template<typename Call_T, typename Value_T>
+  inline VALUE Vectorizer<Function_T, IsMethod>::invoke(Call_T& call, To_Ruby<Return_T>& toRuby, Value_T&& value)
+  {
+    if constexpr (std::is_void_v<Return_T>)
+    {
+      call(std::forward<Value_T>(value));
+      return Qnil;
+    }
+    else
+    {
+      return toRuby.convert(call(std::forward<Value_T>(value)));
+    }
+  }
+
+  template<typename Function_T, bool IsMethod>
+  template<typename Call_T>
+  inline VALUE Vectorizer<Function_T, IsMethod>::map(VALUE values, Call_T&& call)
+  {
+    To_Ruby<Return_T> toRuby;
+
+    // Ruby Arrays have their elements converted one at a time. The function can call back into
+    // Ruby and change the Array, so its length is checked again before reading each element.
+    if (rb_type(values) == RUBY_T_ARRAY)
+    {
+      From_Ruby<Arg_T> fromRuby;
+      VALUE result = protect(rb_ary_new_capa, RARRAY_LEN(values));
+
+      for (long i = 0; i < RARRAY_LEN(values); i++)
+      {
+        VALUE element = invoke(call, toRuby, fromRuby.convert(RARRAY_AREF(values, i)));
+        protect(rb_ary_push, result, element);
+      }
+      return result;
+    }
+
+    // Wrapped std::vectors are processed without converting their elements at all. Like Arrays
+    // they can change during the loop, which would invalidate iterators, so they are indexed instead.
+    using Vector_T = std::vector<Element_T>;
+    if (Data_Type<Vector_T>::is_bound() && isTypedData(values, Data_Type<Vector_T>::ruby_data_type()))
+    {
+      Vector_T* vector = unwrap<Vector_T>(values, Data_Type<Vector_T>::ruby_data_type());
+      VALUE result = protect(rb_ary_new_capa, (long)vector->size());
+
+      for (size_t i = 0; i < vector->size(); i++)
+      {
+        auto&& item = (*vector)[i];
+        VALUE element = Qnil;
+        if constexpr (std::is_pointer_v<Arg_T>)
+        {
+          element = invoke(call, toRuby, &item);
+        }
+        else
+        {
+          element = invoke(call, toRuby, item);
+        }
+        protect(rb_ary_push, result, element);
+      }
+      return result;
+    }
+
+    throw Exception(rb_eTypeError, "wrong argument type %s (expected Array or %s)",
+      rb_obj_classname(values), Data_Type<Vector_T>::is_bound() ? rb_class2name(Data_Type<Vector_T>::klass().value()) : "std::vector");
+  }
+}
@@ -2,6 +2,7 @@
 #define Rice__detail__Wrapper__hpp_
 
 #include "ruby.hpp"
+#include "../ruby_memsize.hpp"
 
 namespace Rice
 {
@@ -14,8 +15,12 @@ public:
   virtual ~Wrapper() = default;
   virtual void* get() = 0;
 
+  // Updates references to Ruby objects after GC compaction has moved them
+  virtual void ruby_compact();
+
   void ruby_mark();
-  void addKeepAlive(VALUE value);
+  // Keeps value alive as long as owner, the Ruby object of this wrapper, is alive
+  void addKeepAlive(VALUE owner, VALUE value);
 
 private:
   // We use a vector for speed and memory locality versus a set which does
@@ -24,6 +29,9 @@ private:
   std::vector<VALUE> keepAlive_;
 };
 
+template <typename T>
+class WrapperValue;
+
 template <typename T, typename Wrapper_T = void>
 VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T& data, bool isOwner);
 
@@ -35,9 +43,25 @@ T* unwrap(VALUE value, rb_data_type_t* rb_type);
 
 Wrapper* getWrapper(VALUE value, rb_data_type_t* rb_type);
 
+// Checks if value wraps an object of rb_type or of a type that inherits from it. Unlike
+// rb_check_typeddata this never raises and thus does not need to be protected.
+bool isTypedData(VALUE value, const rb_data_type_t* rb_type);
+
+// Data_Type stores the address of this tag in the data field of every rb_data_type_t it
+// creates, so that objects wrapped by Rice can be told apart from other T_DATA objects
+inline char wrappedTypeTag = 0;
+
+// Checks if value is an object wrapped by Rice
+bool isWrapped(VALUE value);
+
 template <typename T>
 void replace(VALUE value, rb_data_type_t* rb_type, T* data, bool isOwner);
 
+// Constructs a T owned by value. The object is stored inside its wrapper so creating it
+// takes a single allocation.
+template <typename T, typename Wrapper_T = WrapperValue<T>, typename...Arg_Ts>
+T* emplace(VALUE value, rb_data_type_t* rb_type, Arg_Ts&&...args);
+
 Wrapper* getWrapper(VALUE value);
 
 } // namespace detail
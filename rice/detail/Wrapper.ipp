@@ -1,4 +1,5 @@
 #include <memory>
+#include <utility>
 #include "InstanceRegistry.hpp"
 
 namespace Rice::detail
@@ -7,26 +8,96 @@ namespace Rice::detail
   {
     for (VALUE value : this->keepAlive_)
     {
-      rb_gc_mark(value);
+      // C++ code holds on to the data of wrapped objects, not their Ruby objects, so those
+      // can be moved by compaction. Any other value may have been stored by C++ code as a
+      // VALUE, which compaction cannot update, and thus is pinned.
+      if (isWrapped(value))
+      {
+        rb_gc_mark_movable(value);
+      }
+      else
+      {
+        rb_gc_mark(value);
+      }
     }
   }
 
-  inline void Wrapper::addKeepAlive(VALUE value)
+  inline void Wrapper::ruby_compact()
+  {
+    for (VALUE& value : this->keepAlive_)
+    {
+      value = rb_gc_location(value);
+    }
+
+    // If the wrapped object is tracked then the registry may point at our old location
+    Registries::instance.instances.compact(this->get());
+  }
+
+  inline void Wrapper::addKeepAlive(VALUE owner, VALUE value)
   {
     this->keepAlive_.push_back(value);
+
+    // Owner may be write barrier protected, so tell the garbage collector about the new reference
+    RB_OBJ_WRITTEN(owner, Qundef, value);
   }
 
+  // Tells Ruby about memory owned by a wrapped object so that growing C++ allocations
+  // trigger garbage collections. Only done for types that opt in, for all other types
+  // this is an empty base class and thus takes no space.
+  template <typename T, bool = ruby_adjust_memory_usage<T>::value>
+  class MemoryUsage
+  {
+  protected:
+    void allocated(const T* data)
+    {
+    }
+
+    void freed()
+    {
+    }
+  };
+
   template <typename T>
-  class WrapperValue : public Wrapper
+  class MemoryUsage<T, true>
+  {
+  protected:
+    void allocated(const T* data)
+    {
+      this->size_ = (ssize_t)ruby_memsize<T>(data);
+      rb_gc_adjust_memory_usage(this->size_);
+    }
+
+    // The object may have grown or shrunk since it was created, so subtract exactly
+    // what was added to keep Ruby's count balanced
+    void freed()
+    {
+      rb_gc_adjust_memory_usage(-this->size_);
+      this->size_ = 0;
+    }
+
+  private:
+    ssize_t size_ = 0;
+  };
+
+  template <typename T>
+  class WrapperValue : public Wrapper, private MemoryUsage<T>
   {
   public:
     WrapperValue(T& data): data_(std::move(data))
     {
+      this->allocated(&this->data_);
+    }
+
+    template <typename...Arg_Ts>
+    WrapperValue(std::in_place_t, Arg_Ts&&...args) : data_(std::forward<Arg_Ts>(args)...)
+    {
+      this->allocated(&this->data_);
     }
 
     ~WrapperValue()
     {
       Registries::instance.instances.remove(this->get());
+      this->freed();
     }
 
     void* get() override
@@ -61,11 +132,15 @@ namespace Rice::detail
   };
 
   template <typename T>
-  class WrapperPointer : public Wrapper
+  class WrapperPointer : public Wrapper, private MemoryUsage<T>
   {
   public:
     WrapperPointer(T* data, bool isOwner) : data_(data), isOwner_(isOwner)
     {
+      if (this->isOwner_ && this->data_)
+      {
+        this->allocated(this->data_);
+      }
     }
 
     ~WrapperPointer()
@@ -74,6 +149,7 @@ namespace Rice::detail
 
       if (this->isOwner_)
       {
+        this->freed();
         delete this->data_;
       }
     }
@@ -92,7 +168,7 @@ namespace Rice::detail
   template <typename T, typename Wrapper_T>
   inline VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T& data, bool isOwner)
   {
-    VALUE result = Registries::instance.instances.lookup(&data);
+    VALUE result = Registries::instance.instances.lookup(&data, rb_type);
 
     if (result != Qnil)
       return result;
@@ -133,7 +209,7 @@ namespace Rice::detail
   template <typename T, typename Wrapper_T>
   inline VALUE wrap(VALUE klass, rb_data_type_t* rb_type, T* data, bool isOwner)
   {
-    VALUE result = Registries::instance.instances.lookup(data);
+    VALUE result = Registries::instance.instances.lookup(data, rb_type);
 
     if (result != Qnil)
       return result;
@@ -174,9 +250,32 @@ namespace Rice::detail
     
   inline Wrapper* getWrapper(VALUE value, rb_data_type_t* rb_type)
   {
-    Wrapper* wrapper = nullptr;
-    TypedData_Get_Struct(value, Wrapper, rb_type, wrapper);
-    return wrapper;
+    if (!isTypedData(value, rb_type))
+    {
+      // Raises a TypeError that names the expected type
+      protect(rb_check_typeddata, value, (const rb_data_type_t*)rb_type);
+    }
+
+    return getWrapper(value);
+  }
+
+  inline bool isTypedData(VALUE value, const rb_data_type_t* rb_type)
+  {
+    if (!RB_TYPE_P(value, RUBY_T_DATA) || !RTYPEDDATA_P(value))
+    {
+      return false;
+    }
+
+    // Most objects are instances of the exact type so check that first before walking
+    // the type's parents
+    const rb_data_type_t* valueType = RTYPEDDATA_TYPE(value);
+    return valueType == rb_type || rb_typeddata_inherited_p(valueType, rb_type);
+  }
+
+  inline bool isWrapped(VALUE value)
+  {
+    return RB_TYPE_P(value, RUBY_T_DATA) && RTYPEDDATA_P(value) &&
+           RTYPEDDATA_TYPE(value)->data == &wrappedTypeTag;
   }
 
   template <typename T>
@@ -196,6 +295,27 @@ namespace Rice::detail
     Registries::instance.instances.add(data, value);
   }
 
+  template <typename T, typename Wrapper_T, typename...Arg_Ts>
+  inline T* emplace(VALUE value, rb_data_type_t* rb_type, Arg_Ts&&...args)
+  {
+    // Construct the new object before touching the existing wrapper in case T's constructor throws.
+    // The new wrapper is owned here until it is installed in case value has the wrong type.
+    std::unique_ptr<Wrapper_T> wrapper(new Wrapper_T(std::in_place, std::forward<Arg_Ts>(args)...));
+    T* data = static_cast<T*>(wrapper->get());
+
+    Wrapper* existing = getWrapper(value, rb_type);
+    if (existing)
+    {
+      Registries::instance.instances.remove(existing->get());
+      delete existing;
+    }
+
+    RTYPEDDATA_DATA(value) = wrapper.release();
+
+    Registries::instance.instances.add(data, value);
+    return data;
+  }
+
   inline Wrapper* getWrapper(VALUE value)
   {
     // Turn off spurious warning on g++ 12
@@ -1,6 +1,7 @@
 #ifndef Rice__detail__from_ruby__ipp_
 #define Rice__detail__from_ruby__ipp_
 
+#include <limits>
 #include <optional>
 #include <stdexcept>
 #include "../Exception_defn.hpp"
@@ -11,6 +12,53 @@
    such as bool, int, float, etc. It also includes conversions for chars and strings */
 namespace Rice::detail
 {
+  // Fixnums that fit in the target type are converted inline. Everything else - Bignums,
+  // Floats, objects that implement to_int and out of range values - is passed to Ruby's
+  // conversion function, which can raise and thus has to be protected.
+  template<typename T, typename Function_T>
+  inline T integerFromRuby(VALUE value, Function_T convertFunc)
+  {
+    if (RB_LIKELY(RB_FIXNUM_P(value)))
+    {
+      long result = RB_FIX2LONG(value);
+
+      if constexpr (std::is_signed_v<T>)
+      {
+        if (result >= std::numeric_limits<T>::min() && result <= std::numeric_limits<T>::max())
+        {
+          return (T)result;
+        }
+      }
+      else
+      {
+        if (result >= 0 && (unsigned long)result <= std::numeric_limits<T>::max())
+        {
+          return (T)result;
+        }
+      }
+    }
+
+    return (T)protect(convertFunc, value);
+  }
+
+  // Floats (both Flonums and heap allocated) and Fixnums are converted inline. Other
+  // values need to be coerced by rb_num2dbl, which can raise.
+  inline double floatFromRuby(VALUE value)
+  {
+    if (RB_LIKELY(RB_FLOAT_TYPE_P(value)))
+    {
+      return call_unprotected(rb_float_value, value);
+    }
+    else if (RB_FIXNUM_P(value))
+    {
+      return (double)RB_FIX2LONG(value);
+    }
+    else
+    {
+      return protect(rb_num2dbl, value);
+    }
+  }
+
   // ===========  short  ============
   template<>
   class From_Ruby<short>
@@ -18,7 +66,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<short>())
     {
     }
 
@@ -29,18 +77,18 @@ namespace Rice::detail
 
     short convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<short>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2short_inline, value);
+        return integerFromRuby<short>(value, rb_num2short_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    short* defaultValue_ = nullptr;
   };
 
   template<>
@@ -49,7 +97,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<short>())
     {
     }
 
@@ -60,19 +108,19 @@ namespace Rice::detail
 
     short& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<short>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2short_inline, value);
+        this->converted_ = integerFromRuby<short>(value, rb_num2short_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    short* defaultValue_ = nullptr;
     short converted_ = 0;
   };
 
@@ -93,7 +141,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2short_inline, value);
+        this->converted_ = integerFromRuby<short>(value, rb_num2short_inline);
         return &this->converted_;
       }
     }
@@ -109,7 +157,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<int>())
     {
     }
 
@@ -120,18 +168,18 @@ namespace Rice::detail
 
     int convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<int>();
+        return *this->defaultValue_;
       }
       else
       {
-        return (int)protect(rb_num2long_inline, value);
+        return integerFromRuby<int>(value, rb_num2long_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    int* defaultValue_ = nullptr;
   };
 
   template<>
@@ -140,7 +188,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<int>())
     {
     }
 
@@ -151,19 +199,19 @@ namespace Rice::detail
 
     int& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<int>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = (int)protect(rb_num2long_inline, value);
+        this->converted_ = integerFromRuby<int>(value, rb_num2long_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    int* defaultValue_ = nullptr;
     int converted_ = 0;
   };
 
@@ -184,7 +232,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = (int)protect(rb_num2long_inline, value);
+        this->converted_ = integerFromRuby<int>(value, rb_num2long_inline);
         return &this->converted_;
       }
     }
@@ -200,7 +248,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<long>())
     {
     }
 
@@ -211,18 +259,18 @@ namespace Rice::detail
 
     long convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<long>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2long_inline, value);
+        return integerFromRuby<long>(value, rb_num2long_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    long* defaultValue_ = nullptr;
   };
 
   template<>
@@ -231,7 +279,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<long>())
     {
     }
 
@@ -242,19 +290,19 @@ namespace Rice::detail
 
     long& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<long>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2long_inline, value);
+        this->converted_ = integerFromRuby<long>(value, rb_num2long_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    long* defaultValue_ = nullptr;
     long converted_ = 0;
   };
 
@@ -275,7 +323,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2long_inline, value);
+        this->converted_ = integerFromRuby<long>(value, rb_num2long_inline);
         return &this->converted_;
       }
     }
@@ -291,7 +339,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<long long>())
     {
     }
 
@@ -302,18 +350,18 @@ namespace Rice::detail
 
     long long convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<long long>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2ll_inline, value);
+        return integerFromRuby<long long>(value, rb_num2ll_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    long long* defaultValue_ = nullptr;
   };
 
   template<>
@@ -322,7 +370,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<long long>())
     {
     }
 
@@ -333,19 +381,19 @@ namespace Rice::detail
 
     long long& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<long long>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2ll_inline, value);
+        this->converted_ = integerFromRuby<long long>(value, rb_num2ll_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    long long* defaultValue_ = nullptr;
     long long converted_ = 0;
   };
 
@@ -366,7 +414,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2ll_inline, value);
+        this->converted_ = integerFromRuby<long long>(value, rb_num2ll_inline);
         return &this->converted_;
       }
     }
@@ -382,7 +430,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned short>())
     {
     }
 
@@ -393,18 +441,18 @@ namespace Rice::detail
 
     unsigned short convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned short>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2ushort, value);
+        return integerFromRuby<unsigned short>(value, rb_num2ushort);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    unsigned short* defaultValue_ = nullptr;
   };
 
   template<>
@@ -413,7 +461,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned short>())
     {
     }
 
@@ -424,19 +472,19 @@ namespace Rice::detail
 
     unsigned short& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned short>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2ushort, value);
+        this->converted_ = integerFromRuby<unsigned short>(value, rb_num2ushort);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    unsigned short* defaultValue_ = nullptr;
     unsigned short converted_ = 0;
   };
 
@@ -457,7 +505,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2ushort, value);
+        this->converted_ = integerFromRuby<unsigned short>(value, rb_num2ushort);
         return &this->converted_;
       }
     }
@@ -473,7 +521,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned int>())
     {
     }
 
@@ -484,18 +532,18 @@ namespace Rice::detail
 
     unsigned int convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned int>();
+        return *this->defaultValue_;
       }
       else
       {
-        return (unsigned int)protect(rb_num2ulong_inline, value);
+        return integerFromRuby<unsigned int>(value, rb_num2ulong_inline);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    unsigned int* defaultValue_ = nullptr;
   };
 
   template<>
@@ -504,7 +552,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned int>())
     {
     }
 
@@ -515,19 +563,19 @@ namespace Rice::detail
 
     unsigned int& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned int>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = (unsigned int)protect(rb_num2ulong_inline, value);
+        this->converted_ = integerFromRuby<unsigned int>(value, rb_num2ulong_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    unsigned int* defaultValue_ = nullptr;
     unsigned int converted_ = 0;
   };
 
@@ -548,7 +596,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = (unsigned int)protect(rb_num2ulong_inline, value);
+        this->converted_ = integerFromRuby<unsigned int>(value, rb_num2ulong_inline);
         return &this->converted_;
       }
     }
@@ -564,7 +612,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : arg_(arg), defaultValue_(arg->defaultValuePointer<unsigned long>())
     {
     }
 
@@ -579,18 +627,19 @@ namespace Rice::detail
       {
         return (unsigned long)value;
       }
-      else if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      else if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned long>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2ulong_inline, value);
+        return integerFromRuby<unsigned long>(value, rb_num2ulong_inline);
       }
     }
   
   private:
     Arg* arg_ = nullptr;
+    unsigned long* defaultValue_ = nullptr;
   };
 
   template<>
@@ -599,7 +648,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned long>())
     {
     }
 
@@ -610,19 +659,19 @@ namespace Rice::detail
 
     unsigned long& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned long>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2ulong_inline, value);
+        this->converted_ = integerFromRuby<unsigned long>(value, rb_num2ulong_inline);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    unsigned long* defaultValue_ = nullptr;
     unsigned long converted_ = 0;
   };
 
@@ -643,7 +692,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2ulong_inline, value);
+        this->converted_ = integerFromRuby<unsigned long>(value, rb_num2ulong_inline);
         return &this->converted_;
       }
     }
@@ -659,7 +708,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : arg_(arg), defaultValue_(arg->defaultValuePointer<unsigned long long>())
     {
     }
 
@@ -674,18 +723,19 @@ namespace Rice::detail
       {
         return value;
       }
-      else if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      else if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned long long>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2ull, value);
+        return integerFromRuby<unsigned long long>(value, rb_num2ull);
       }
     }
   
   private:
     Arg* arg_ = nullptr;
+    unsigned long long* defaultValue_ = nullptr;
   };
 
   template<>
@@ -694,7 +744,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned long long>())
     {
     }
 
@@ -705,19 +755,19 @@ namespace Rice::detail
 
     unsigned long long& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned long long>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2ull, value);
+        this->converted_ = integerFromRuby<unsigned long long>(value, rb_num2ull);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    unsigned long long* defaultValue_ = nullptr;
     unsigned long long converted_ = 0;
   };
 
@@ -738,7 +788,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2ull, value);
+        this->converted_ = integerFromRuby<unsigned long long>(value, rb_num2ull);
         return &this->converted_;
       }
     }
@@ -754,7 +804,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<bool>())
     {
     }
 
@@ -768,9 +818,9 @@ namespace Rice::detail
 
     bool convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<bool>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -779,7 +829,7 @@ namespace Rice::detail
     }
   
   private:
-    Arg* arg_ = nullptr;
+    bool* defaultValue_ = nullptr;
   };
 
   template<>
@@ -788,7 +838,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<bool>())
     {
     }
 
@@ -802,9 +852,9 @@ namespace Rice::detail
 
     bool& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<bool>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -814,7 +864,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    bool* defaultValue_ = nullptr;
     bool converted_ = false;
   };
 
@@ -884,7 +934,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<char>())
     {
     }
 
@@ -895,9 +945,9 @@ namespace Rice::detail
 
     char convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<char>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -906,7 +956,7 @@ namespace Rice::detail
     }
   
   private:
-    Arg* arg_ = nullptr;
+    char* defaultValue_ = nullptr;
   };
 
   template<>
@@ -915,7 +965,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<char>())
     {
     }
 
@@ -926,9 +976,9 @@ namespace Rice::detail
 
     char& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<char>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -938,7 +988,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    char* defaultValue_ = nullptr;
     char converted_ = 0;
   };
 
@@ -959,7 +1009,7 @@ namespace Rice::detail
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
+        detail::checkString(value);
         return RSTRING_PTR(value);
       }
     }
@@ -983,7 +1033,7 @@ namespace Rice::detail
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
+        detail::checkString(value);
         return RSTRING_PTR(value);
       }
     }
@@ -996,7 +1046,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<unsigned char>())
     {
     }
 
@@ -1007,9 +1057,9 @@ namespace Rice::detail
 
     unsigned char convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<unsigned char>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -1018,7 +1068,7 @@ namespace Rice::detail
     }
   
   private:
-    Arg* arg_ = nullptr;
+    unsigned char* defaultValue_ = nullptr;
   };
 
   // ===========  signed char  ============
@@ -1028,7 +1078,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<signed char>())
     {
     }
 
@@ -1039,9 +1089,9 @@ namespace Rice::detail
 
     signed char convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<signed char>();
+        return *this->defaultValue_;
       }
       else
       {
@@ -1050,7 +1100,7 @@ namespace Rice::detail
     }
   
   private:
-    Arg* arg_ = nullptr;
+    signed char* defaultValue_ = nullptr;
   };
 
   // ===========  double  ============
@@ -1060,7 +1110,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<double>())
     {
     }
 
@@ -1071,18 +1121,18 @@ namespace Rice::detail
 
     double convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<double>();
+        return *this->defaultValue_;
       }
       else
       {
-        return protect(rb_num2dbl, value);
+        return floatFromRuby(value);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    double* defaultValue_ = nullptr;
   };
 
   template<>
@@ -1091,7 +1141,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<double>())
     {
     }
 
@@ -1102,19 +1152,19 @@ namespace Rice::detail
 
     double& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<double>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = protect(rb_num2dbl, value);
+        this->converted_ = floatFromRuby(value);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    double* defaultValue_ = nullptr;
     double converted_;
   };
 
@@ -1135,7 +1185,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = protect(rb_num2dbl, value);
+        this->converted_ = floatFromRuby(value);
         return &this->converted_;
       }
     }
@@ -1151,7 +1201,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<float>())
     {
     }
 
@@ -1162,18 +1212,18 @@ namespace Rice::detail
 
     float convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<float>();
+        return *this->defaultValue_;
       }
       else
       {
-        return (float)protect(rb_num2dbl, value);
+        return (float)floatFromRuby(value);
       }
     }
   
   private:
-    Arg* arg_ = nullptr;
+    float* defaultValue_ = nullptr;
   };
 
   template<>
@@ -1182,7 +1232,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<float>())
     {
     }
 
@@ -1193,19 +1243,19 @@ namespace Rice::detail
 
     float& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<float>();
+        return *this->defaultValue_;
       }
       else
       {
-        this->converted_ = (float)protect(rb_num2dbl, value);
+        this->converted_ = (float)floatFromRuby(value);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    float* defaultValue_ = nullptr;
     float converted_;
   };
 
@@ -1226,7 +1276,7 @@ namespace Rice::detail
       }
       else
       {
-        this->converted_ = (float)protect(rb_num2dbl, value);
+        this->converted_ = (float)floatFromRuby(value);
         return &this->converted_;
       }
     }
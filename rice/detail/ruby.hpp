@@ -9,6 +9,8 @@
 #include <cmath>
 
 #include <ruby.h>
+#include <ruby/encoding.h>
+#include <ruby/version.h>
 
 // ruby.h has a few defines that conflict with Visual Studio's STL
 #if defined(_MSC_VER)
@@ -27,6 +29,19 @@
 // work on all platforms.  I'm not sure what to do about this.
 extern "C" typedef VALUE (*RUBY_VALUE_FUNC)(VALUE);
 
+// GC compaction was added in Ruby 2.7. Older versions never move objects.
+#if RUBY_API_VERSION_MAJOR == 2 && RUBY_API_VERSION_MINOR < 7
+inline void rb_gc_mark_movable(VALUE value)
+{
+  rb_gc_mark(value);
+}
+
+inline VALUE rb_gc_location(VALUE value)
+{
+  return value;
+}
+#endif
+
 // Fix Ruby RUBY_METHOD_FUNC from macro to typedef
 #if defined(RUBY_METHOD_FUNC)
 # undef RUBY_METHOD_FUNC
@@ -1,10 +1,168 @@
 #include "RubyFunction.hpp"
 #include "../Return.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
 namespace Rice
 {
   namespace detail
   {
+    // Integers that fit in a Fixnum are converted inline. Larger values need a Bignum,
+    // which is allocated and thus has to be protected.
+    template<typename T>
+    inline bool isFixable(T x)
+    {
+      if constexpr (std::is_signed_v<T>)
+      {
+        return x >= RUBY_FIXNUM_MIN && x <= RUBY_FIXNUM_MAX;
+      }
+      else
+      {
+        return x <= (unsigned long)RUBY_FIXNUM_MAX;
+      }
+    }
+
+    // Doubles that can be stored as a Flonum do not need to be allocated, so rb_float_new
+    // cannot raise. This mirrors the range check in rb_float_new_inline.
+    inline bool isFlonum(double x)
+    {
+#if USE_FLONUM
+      uint64_t bits;
+      std::memcpy(&bits, &x, sizeof(bits));
+      int exponent = (int)((bits >> 60) & 0x7);
+      return bits == 0 || (bits != 0x3000000000000000 && !((exponent - 3) & ~0x01));
+#else
+      return false;
+#endif
+    }
+
+    // Returns the frozen, deduplicated string for the given bytes. If the string has already
+    // been interned this does not allocate.
+    inline VALUE internedStringToRuby(const char* data, long length, rb_encoding* encoding)
+    {
+#if RUBY_API_VERSION_MAJOR >= 3
+      return protect(rb_enc_interned_str, data, length, encoding);
+#else
+      VALUE string = protect(rb_enc_str_new, data, length, encoding);
+      return protect(rb_funcallv, string, rb_intern("-@"), 0, nullptr);
+#endif
+    }
+
+    // Creates a Ruby string with the encoding requested by the method's Return options
+    inline VALUE stringToRuby(const char* data, long length, Return* returnInfo)
+    {
+      bool interned = returnInfo && returnInfo->isInterned();
+
+      if (returnInfo && returnInfo->isBinary())
+      {
+        return interned ? internedStringToRuby(data, length, rb_ascii8bit_encoding()) :
+                          protect(rb_str_new, data, length);
+      }
+      else if (returnInfo && returnInfo->isUtf8())
+      {
+        return interned ? internedStringToRuby(data, length, rb_utf8_encoding()) :
+                          protect(rb_utf8_str_new, data, length);
+      }
+      else if (interned && !rb_default_internal_encoding())
+      {
+        return internedStringToRuby(data, length, rb_default_external_encoding());
+      }
+      else
+      {
+        // The string may have to be transcoded to Encoding.default_internal before it is interned
+        VALUE result = protect(rb_external_str_new, data, length);
+        return interned ? protect(rb_funcallv, result, rb_intern("-@"), 0, nullptr) : result;
+      }
+    }
+
+    // Caches the interned strings returned for char* results, keyed by pointer. Functions that
+    // return enum-like strings usually return string literals, so this skips hashing the string
+    // on every call. A hit still compares the contents in case the pointer has been reused.
+    class InternedStringCache
+    {
+    public:
+      static VALUE lookup(const char* data, rb_encoding* encoding);
+
+    private:
+      struct Entry
+      {
+        const char* data;
+        rb_encoding* encoding;
+      };
+
+      static constexpr long Size = 64;
+      inline static std::array<Entry, Size> entries_{};
+
+      // Holds the cached strings so they are not garbage collected
+      inline static VALUE strings_ = Qnil;
+    };
+
+    inline VALUE InternedStringCache::lookup(const char* data, rb_encoding* encoding)
+    {
+      if (strings_ == Qnil)
+      {
+        rb_gc_register_address(&strings_);
+        strings_ = protect(rb_ary_new_capa, Size);
+      }
+
+      long length = (long)strlen(data);
+      long index = (long)(std::hash<const char*>()(data) % Size);
+      Entry& entry = entries_[index];
+
+      if (entry.data == data && entry.encoding == encoding)
+      {
+        VALUE cached = call_unprotected(rb_ary_entry, strings_, index);
+        if (RSTRING_LEN(cached) == length && std::memcmp(RSTRING_PTR(cached), data, length) == 0)
+        {
+          return cached;
+        }
+      }
+
+      VALUE result = internedStringToRuby(data, length, encoding);
+      protect(rb_ary_store, strings_, index, result);
+      entry.data = data;
+      entry.encoding = encoding;
+      return result;
+    }
+
+    // Converts strings that start with ':' to Symbols. The ID is cached by the string's address
+    // so that a converter returning the same string literal on every call does not have to
+    // look it up again. A hit still compares the name in case the address has been reused.
+    class SymbolCache
+    {
+    public:
+      VALUE convert(const char* name, long length);
+
+    private:
+      const char* name_ = nullptr;
+      ID id_ = 0;
+      VALUE symbol_ = Qnil;
+    };
+
+    inline VALUE SymbolCache::convert(const char* name, long length)
+    {
+      if (name == this->name_)
+      {
+        const char* cached = call_unprotected(rb_id2name, this->id_);
+        if (cached && std::strncmp(cached, name, length) == 0 && cached[length] == '\0')
+        {
+          return this->symbol_;
+        }
+      }
+
+      this->id_ = protect(rb_intern2, name, length);
+      this->symbol_ = protect(rb_id2sym, this->id_);
+
+      // Only static symbols are immediate values. Dynamic ones are heap objects that the
+      // cache would have to keep alive, so they are not cached.
+      this->name_ = RB_STATIC_SYM_P(this->symbol_) ? name : nullptr;
+      return this->symbol_;
+    }
+
     template<>
     class To_Ruby<void>
     {
@@ -31,6 +189,10 @@ namespace Rice
     public:
       VALUE convert(short const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_int2num_inline, (int)x);
 #else
@@ -45,6 +207,10 @@ namespace Rice
     public:
       VALUE convert(short const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_int2num_inline, (int)x);
 #else
@@ -59,6 +225,10 @@ namespace Rice
     public:
       VALUE convert(int const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_int2num_inline, (int)x);
 #else
@@ -73,6 +243,10 @@ namespace Rice
     public:
       VALUE convert(int const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_int2num_inline, (int)x);
 #else
@@ -87,6 +261,10 @@ namespace Rice
     public:
       VALUE convert(long const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
         return protect(rb_long2num_inline, x);
       }
     };
@@ -97,6 +275,10 @@ namespace Rice
     public:
       VALUE convert(long const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
         return protect(rb_long2num_inline, x);
       }
     };
@@ -107,6 +289,10 @@ namespace Rice
     public:
       VALUE convert(long long const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
         return protect(rb_ll2inum, x);
       }
     };
@@ -117,6 +303,10 @@ namespace Rice
     public:
       VALUE convert(long long const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
         return protect(rb_ll2inum, x);
       }
     };
@@ -127,6 +317,10 @@ namespace Rice
     public:
       VALUE convert(unsigned short const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_uint2num_inline, (unsigned int)x);
 #else
@@ -141,6 +335,10 @@ namespace Rice
     public:
       VALUE convert(unsigned short const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_uint2num_inline, (unsigned int)x);
 #else
@@ -155,6 +353,10 @@ namespace Rice
     public:
       VALUE convert(unsigned int const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_uint2num_inline, (unsigned int)x);
 #else
@@ -169,6 +371,10 @@ namespace Rice
     public:
       VALUE convert(unsigned int const& x)
       {
+        if (RB_LIKELY(isFixable(x)))
+        {
+          return RB_LONG2FIX((long)x);
+        }
 #ifdef rb_int2num_inline
         return protect(rb_uint2num_inline, (unsigned int)x);
 #else
@@ -195,6 +401,10 @@ namespace Rice
         }
         else
         {
+          if (RB_LIKELY(isFixable(x)))
+          {
+            return RB_LONG2FIX((long)x);
+          }
           return protect(rb_ulong2num_inline, x);
         }
       }
@@ -221,6 +431,10 @@ namespace Rice
         }
         else
         {
+          if (RB_LIKELY(isFixable(x)))
+          {
+            return RB_LONG2FIX((long)x);
+          }
           return protect(rb_ulong2num_inline, x);
         }
       }
@@ -247,6 +461,10 @@ namespace Rice
         }
         else
         {
+          if (RB_LIKELY(isFixable(x)))
+          {
+            return RB_LONG2FIX((long)x);
+          }
           return protect(rb_ull2inum, (unsigned long long)x);
         }
       }
@@ -273,6 +491,10 @@ namespace Rice
         }
         else
         {
+          if (RB_LIKELY(isFixable(x)))
+          {
+            return RB_LONG2FIX((long)x);
+          }
           return protect(rb_ull2inum, (unsigned long long)x);
         }
       }
@@ -287,6 +509,10 @@ namespace Rice
     public:
       VALUE convert(float const& x)
       {
+        if (RB_LIKELY(isFlonum(x)))
+        {
+          return call_unprotected(rb_float_new, (double)x);
+        }
         return protect(rb_float_new, (double)x);
       }
     };
@@ -297,6 +523,10 @@ namespace Rice
     public:
       VALUE convert(float const& x)
       {
+        if (RB_LIKELY(isFlonum(x)))
+        {
+          return call_unprotected(rb_float_new, (double)x);
+        }
         return protect(rb_float_new, (double)x);
       }
     };
@@ -307,6 +537,10 @@ namespace Rice
     public:
       VALUE convert(double const& x)
       {
+        if (RB_LIKELY(isFlonum(x)))
+        {
+          return call_unprotected(rb_float_new, (double)x);
+        }
         return protect(rb_float_new, x);
       }
     };
@@ -317,6 +551,10 @@ namespace Rice
     public:
       VALUE convert(double const& x)
       {
+        if (RB_LIKELY(isFlonum(x)))
+        {
+          return call_unprotected(rb_float_new, (double)x);
+        }
         return protect(rb_float_new, x);
       }
     };
@@ -405,22 +643,37 @@ namespace Rice
     class To_Ruby<char*>
     {
     public:
+      To_Ruby() = default;
+
+      explicit To_Ruby(Return* returnInfo) : returnInfo_(returnInfo)
+      {
+      }
+
       VALUE convert(char const* x)
       {
-        if (strlen(x) > 0 && x[0] == ':')
+        if (x[0] == ':')
         {
-          size_t symbolLength = strlen(x) - 1;
-          char* symbol = new char[symbolLength];
-          strncpy(symbol, x + 1, symbolLength);
-          ID id = protect(rb_intern2, symbol, (long)symbolLength);
-          delete[] symbol;
-          return protect(rb_id2sym, id);
+          return this->symbolCache_.convert(x + 1, (long)std::strlen(x + 1));
+        }
+        else if (this->returnInfo_ && this->returnInfo_->isInterned())
+        {
+          // char* results are binary unless utf8() is specified
+          rb_encoding* encoding = this->returnInfo_->isUtf8() ? rb_utf8_encoding() : rb_ascii8bit_encoding();
+          return InternedStringCache::lookup(x, encoding);
+        }
+        else if (this->returnInfo_ && this->returnInfo_->isUtf8())
+        {
+          return protect(rb_utf8_str_new_cstr, x);
         }
         else
         {
           return protect(rb_str_new2, x);
         }
       }
+
+    private:
+      Return* returnInfo_ = nullptr;
+      SymbolCache symbolCache_;
     };
 
     template<int N>
@@ -431,18 +684,18 @@ namespace Rice
       {
         if (N > 0 && x[0] == ':')
         {
-          // N count includes a NULL character at the end of the string
-          constexpr size_t symbolLength = N - 1;
-          char symbol[symbolLength];
-          strncpy(symbol, x + 1, symbolLength);
-          ID id = protect(rb_intern, symbol);
-          return protect(rb_id2sym, id);
+          // The array may be longer than the string it holds
+          const char* end = std::find(x + 1, x + N, '\0');
+          return this->symbolCache_.convert(x + 1, (long)(end - x - 1));
         }
         else
         {
           return protect(rb_str_new2, x);
         }
       }
+
+    private:
+      SymbolCache symbolCache_;
     };
   }
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef Rice__detail__without_gvl__hpp_
+#define Rice__detail__without_gvl__hpp_
+
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+
+#include "ruby.hpp"
+#include <ruby/thread.h>
+#include "../NoGVL.hpp"
+
+namespace Rice::detail
+{
+  // Calls func with the values in the args tuple while Ruby's GVL is released. C++ exceptions
+  // cannot unwind through Ruby, so any exception func throws is rethrown after the GVL is
+  // reacquired. Func must not touch Ruby objects.
+  template<typename Function_T, typename Tuple_T>
+  auto without_gvl(const NoGVL& noGVL, Function_T&& func, Tuple_T&& args)
+    -> decltype(std::apply(std::forward<Function_T>(func), std::forward<Tuple_T>(args)));
+}
+#include "without_gvl.ipp"
+
+#endif // Rice__detail__without_gvl__hpp_
@@ -0,0 +1,70 @@
+#include "RubyFunction.hpp"
+
+namespace Rice::detail
+{
+  template<typename Function_T, typename Tuple_T>
+  inline auto without_gvl(const NoGVL& noGVL, Function_T&& func, Tuple_T&& args)
+    -> decltype(std::apply(std::forward<Function_T>(func), std::forward<Tuple_T>(args)))
+  {
+    using Result_T = decltype(std::apply(std::forward<Function_T>(func), std::forward<Tuple_T>(args)));
+
+    // References are stored as pointers and values in an optional since they may not be default constructible
+    using Storage_T = std::conditional_t<std::is_void_v<Result_T>, std::nullptr_t,
+                        std::conditional_t<std::is_reference_v<Result_T>, std::remove_reference_t<Result_T>*,
+                          std::optional<Result_T>>>;
+
+    struct Call
+    {
+      Function_T& func;
+      Tuple_T& args;
+      Storage_T result{};
+      std::exception_ptr exception;
+    } call{ func, args };
+
+    void* (*callback)(void*) = [](void* data) -> void*
+    {
+      Call* call = static_cast<Call*>(data);
+      try
+      {
+        if constexpr (std::is_void_v<Result_T>)
+        {
+          std::apply(std::forward<Function_T>(call->func), std::forward<Tuple_T>(call->args));
+        }
+        else if constexpr (std::is_reference_v<Result_T>)
+        {
+          call->result = &std::apply(std::forward<Function_T>(call->func), std::forward<Tuple_T>(call->args));
+        }
+        else
+        {
+          call->result.emplace(std::apply(std::forward<Function_T>(call->func), std::forward<Tuple_T>(call->args)));
+        }
+      }
+      catch (...)
+      {
+        call->exception = std::current_exception();
+      }
+      return nullptr;
+    };
+
+    // Ruby raises pending interrupts (Thread#raise, Thread#kill) when it reacquires the GVL
+    detail::protect(rb_thread_call_without_gvl, callback, (void*)&call, noGVL.unblockFunction(), noGVL.unblockData());
+
+    if (call.exception)
+    {
+      std::rethrow_exception(call.exception);
+    }
+
+    if constexpr (std::is_void_v<Result_T>)
+    {
+      return;
+    }
+    else if constexpr (std::is_reference_v<Result_T>)
+    {
+      return static_cast<Result_T>(*call.result);
+    }
+    else
+    {
+      return std::move(*call.result);
+    }
+  }
+}
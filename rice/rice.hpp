@@ -19,21 +19,29 @@
 #include "detail/TypeRegistry.hpp"
 #include "detail/InstanceRegistry.hpp"
 #include "detail/HandlerRegistry.hpp"
+#include "detail/Native.hpp"
 #include "detail/NativeRegistry.hpp"
 #include "detail/Registries.hpp"
 #include "detail/cpp_protect.hpp"
+#include "detail/NativeSlots.hpp"
+#include "ruby_memsize.hpp"
 #include "detail/Wrapper.hpp"
 #include "Return.hpp"
 #include "Arg.hpp"
+#include "NoGVL.hpp"
+#include "Overload.hpp"
 #include "detail/MethodInfo.hpp"
+#include "detail/without_gvl.hpp"
 #include "detail/from_ruby.hpp"
 #include "detail/to_ruby.hpp"
 #include "Identifier.hpp"
 #include "Exception.ipp"
+#include "detail/NativeOverloads.hpp"
 #include "detail/NativeAttribute.hpp"
 #include "detail/NativeFunction.hpp"
 #include "detail/NativeIterator.hpp"
 #include "HandlerRegistration.hpp"
+#include "detail/Vectorizer.hpp"
 
 // C++ classes for using the Ruby API
 #include "cpp_api/Object.hpp"
@@ -1,6 +1,8 @@
 #ifndef ruby_mark__hpp
 #define ruby_mark__hpp
 
+#include <type_traits>
+
 //! Default function to call to mark a data object.
 /*! This function can be specialized for a particular type to override
  *  the default behavior (which is to not mark any additional objects).
@@ -11,5 +13,18 @@ namespace Rice
   void ruby_mark(T* data)
   {
   }
+
+  //! Whether wrapped objects of type T are write barrier protected.
+  /*! Write barrier protected objects are not rescanned by every minor garbage
+   *  collection, but every Ruby object they reference must be stored with
+   *  RB_OBJ_WRITE (or announced with RB_OBJ_WRITTEN). Rice does this for the
+   *  objects it stores itself, such as keepAlive references. It cannot know
+   *  what a custom ruby_mark function marks, so types opt in by specializing
+   *  this to std::true_type.
+   */
+  template<typename T>
+  struct ruby_wb_protected : std::false_type
+  {
+  };
 }
 #endif // ruby_mark__hpp
@@ -0,0 +1,66 @@
+#ifndef Rice__ruby_memsize__hpp_
+#define Rice__ruby_memsize__hpp_
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Rice::detail
+{
+  // Memory a T owns outside of the object itself, such as the buffer of a std::vector.
+  // The STL support in stl.hpp specializes this for the containers it wraps.
+  template<typename T>
+  struct HeapSize
+  {
+    static size_t size(const T& data)
+    {
+      return 0;
+    }
+  };
+}
+
+namespace Rice
+{
+  //! Default function to call to calculate the memory used by a data object.
+  /*! This is what ObjectSpace.memsize_of reports for wrapped objects. The
+   *  default is sizeof(T) plus the heap memory of the STL containers that
+   *  Rice supports. It can be specialized for a particular type to include
+   *  other memory that the object owns.
+   */
+  template<typename T>
+  size_t ruby_memsize(const T* data)
+  {
+    return sizeof(T) + detail::HeapSize<T>::size(*data);
+  }
+
+  //! Whether Ruby is told about the memory used by wrapped objects of type T.
+  /*! Ruby triggers garbage collections based on how much memory has been
+   *  allocated, but it does not see allocations made by C++ code. Specialize
+   *  this to std::true_type and Rice will report ruby_memsize with
+   *  rb_gc_adjust_memory_usage when a Ruby owned T is created and freed.
+   */
+  template<typename T>
+  struct ruby_adjust_memory_usage : std::false_type
+  {
+  };
+}
+
+namespace Rice::detail
+{
+  // Heap memory owned by an element of a container, including memory reported by a
+  // custom ruby_memsize. Scalars never own memory so containers can skip visiting them.
+  template<typename T>
+  size_t elementHeapSize(const T& data)
+  {
+    if constexpr (std::is_scalar_v<T>)
+    {
+      return 0;
+    }
+    else
+    {
+      // A custom ruby_memsize may report less than sizeof(T)
+      size_t size = ruby_memsize<T>(&data);
+      return size > sizeof(T) ? size - sizeof(T) : 0;
+    }
+  }
+}
+#endif // Rice__ruby_memsize__hpp_
@@ -5,6 +5,7 @@
 #include "../detail/NativeIterator.hpp"
 #include "../Data_Type.hpp"
 #include "../Data_Object.hpp"
+#include "../ruby_memsize.hpp"
 #include "pair.hpp"
 
 #include <sstream>
@@ -303,6 +304,24 @@ namespace Rice
       }
     };
 
+    template<typename T, typename U>
+    struct HeapSize<std::map<T, U>>
+    {
+      static size_t size(const std::map<T, U>& data)
+      {
+        // Each element is stored in a tree node with parent, child and color fields
+        size_t result = data.size() * (sizeof(typename std::map<T, U>::value_type) + 4 * sizeof(void*));
+        if constexpr (!std::is_scalar_v<T> || !std::is_scalar_v<U>)
+        {
+          for (const auto& pair : data)
+          {
+            result += elementHeapSize(pair.first) + elementHeapSize(pair.second);
+          }
+        }
+        return result;
+      }
+    };
+
     template<typename T, typename U>
     struct MapFromHash
     {
@@ -338,7 +357,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::map<T, U>>())
       {
       }
 
@@ -361,9 +380,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::map<T, U>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -375,7 +394,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::map<T, U>* defaultValue_ = nullptr;
     };
 
     template<typename T, typename U>
@@ -384,7 +403,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::map<T, U>>())
       {
       }
 
@@ -408,9 +427,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::map<T, U>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -422,7 +441,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::map<T, U>* defaultValue_ = nullptr;
       std::map<T, U> converted_;
     };
 
@@ -1,4 +1,5 @@
 #include <optional>
+#include "../ruby_memsize.hpp"
 
 namespace Rice::detail
 {
@@ -11,6 +12,15 @@ namespace Rice::detail
     }
   };
 
+  template<typename T>
+  struct HeapSize<std::optional<T>>
+  {
+    static size_t size(const std::optional<T>& data)
+    {
+      return data ? elementHeapSize(*data) : 0;
+    }
+  };
+
   template<>
   class To_Ruby<std::nullopt_t>
   {
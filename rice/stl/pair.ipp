@@ -2,6 +2,7 @@
 #include "../detail/from_ruby.hpp"
 #include "../detail/to_ruby.hpp"
 #include "../Data_Type.hpp"
+#include "../ruby_memsize.hpp"
 
 #include <sstream>
 #include <stdexcept>
@@ -175,5 +176,14 @@ namespace Rice
         return true;
       }
     };
+
+    template<typename T1, typename T2>
+    struct HeapSize<std::pair<T1, T2>>
+    {
+      static size_t size(const std::pair<T1, T2>& data)
+      {
+        return elementHeapSize(data.first) + elementHeapSize(data.second);
+      }
+    };
   }
 }
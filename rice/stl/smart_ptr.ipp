@@ -109,14 +109,14 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg * arg) : arg_(arg)
+    explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::shared_ptr<T>>())
     {
     }
 
     std::shared_ptr<T> convert(VALUE value)
     {
-      if(value == Qnil && this->arg_ && this->arg_->hasDefaultValue()) {
-        return this->arg_->template defaultValue<std::shared_ptr<T>>();
+      if(value == Qnil && this->defaultValue_) {
+        return *this->defaultValue_;
       }
 
       Wrapper* wrapper = detail::getWrapper(value, Data_Type<T>::ruby_data_type());
@@ -132,7 +132,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::shared_ptr<T>* defaultValue_ = nullptr;
   };
 
   template <typename T>
@@ -155,14 +155,14 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg * arg) : arg_(arg)
+    explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::shared_ptr<T>>())
     {
     }
 
     std::shared_ptr<T>& convert(VALUE value)
     {
-      if(value == Qnil && this->arg_ && this->arg_->hasDefaultValue()) {
-        return this->arg_->template defaultValue<std::shared_ptr<T>>();
+      if(value == Qnil && this->defaultValue_) {
+        return *this->defaultValue_;
       }
 
       Wrapper* wrapper = detail::getWrapper(value, Data_Type<T>::ruby_data_type());
@@ -178,7 +178,7 @@ namespace Rice::detail
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::shared_ptr<T>* defaultValue_ = nullptr;
   };
 
   template<typename T>
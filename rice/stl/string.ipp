@@ -3,6 +3,7 @@
 #include "../detail/Type.hpp"
 #include "../detail/from_ruby.hpp"
 #include "../detail/to_ruby.hpp"
+#include "../ruby_memsize.hpp"
 
 namespace Rice::detail
 {
@@ -15,24 +16,75 @@ namespace Rice::detail
     }
   };
 
+  template<>
+  struct HeapSize<std::string>
+  {
+    static size_t size(const std::string& data)
+    {
+      // Short strings are stored inside the string object itself
+      const char* buffer = data.data();
+      const char* object = reinterpret_cast<const char*>(&data);
+      bool isLocal = buffer >= object && buffer < object + sizeof(std::string);
+      return isLocal ? 0 : data.capacity() + 1;
+    }
+  };
+
+  // Converters for std::string& and std::string* live as long as the method and reuse their
+  // string for every call. Once a long argument grows that string, it would keep the memory
+  // forever, so the buffer is replaced when it is much bigger than the current argument.
+  inline void assignString(std::string& converted, VALUE value)
+  {
+    constexpr size_t maxRetainedCapacity = 4096;
+
+    const char* data = RSTRING_PTR(value);
+    size_t length = RSTRING_LEN(value);
+
+    if (converted.capacity() > maxRetainedCapacity && converted.capacity() > 2 * length)
+    {
+      std::string(data, length).swap(converted);
+    }
+    else
+    {
+      converted.assign(data, length);
+    }
+  }
+
   template<>
   class To_Ruby<std::string>
   {
   public:
+    To_Ruby() = default;
+
+    explicit To_Ruby(Return* returnInfo) : returnInfo_(returnInfo)
+    {
+    }
+
     VALUE convert(std::string const& x)
     {
-      return detail::protect(rb_external_str_new, x.data(), (long)x.size());
+      return stringToRuby(x.data(), (long)x.size(), this->returnInfo_);
     }
+
+  private:
+    Return* returnInfo_ = nullptr;
   };
 
   template<>
   class To_Ruby<std::string&>
   {
   public:
+    To_Ruby() = default;
+
+    explicit To_Ruby(Return* returnInfo) : returnInfo_(returnInfo)
+    {
+    }
+
     VALUE convert(std::string const& x)
     {
-      return detail::protect(rb_external_str_new, x.data(), (long)x.size());
+      return stringToRuby(x.data(), (long)x.size(), this->returnInfo_);
     }
+
+  private:
+    Return* returnInfo_ = nullptr;
   };
 
   template<>
@@ -41,7 +93,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<std::string>())
     {
     }
 
@@ -52,19 +104,19 @@ namespace Rice::detail
 
     std::string convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<std::string>();
+        return *this->defaultValue_;
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
+        detail::checkString(value);
         return std::string(RSTRING_PTR(value), RSTRING_LEN(value));
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::string* defaultValue_ = nullptr;
   };
 
   template<>
@@ -73,7 +125,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<std::string>())
     {
     }
 
@@ -84,20 +136,20 @@ namespace Rice::detail
 
     std::string& convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<std::string>();
+        return *this->defaultValue_;
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
-        this->converted_ = std::string(RSTRING_PTR(value), RSTRING_LEN(value));
+        detail::checkString(value);
+        assignString(this->converted_, value);
         return this->converted_;
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::string* defaultValue_ = nullptr;
     std::string converted_;
   };
 
@@ -112,8 +164,8 @@ namespace Rice::detail
 
     std::string* convert(VALUE value)
     {
-      detail::protect(rb_check_type, value, (int)T_STRING);
-      this->converted_ = std::string(RSTRING_PTR(value), RSTRING_LEN(value));
+      detail::checkString(value);
+      assignString(this->converted_, value);
       return &this->converted_;
     }
 
@@ -132,8 +184,8 @@ namespace Rice::detail
 
     std::string* convert(VALUE value)
     {
-      detail::protect(rb_check_type, value, (int)T_STRING);
-      this->converted_ = std::string(RSTRING_PTR(value), RSTRING_LEN(value));
+      detail::checkString(value);
+      assignString(this->converted_, value);
       return &this->converted_;
     }
 
@@ -19,10 +19,19 @@ namespace Rice::detail
   class To_Ruby<std::string_view>
   {
   public:
+    To_Ruby() = default;
+
+    explicit To_Ruby(Return* returnInfo) : returnInfo_(returnInfo)
+    {
+    }
+
     VALUE convert(std::string_view const& x)
     {
-      return detail::protect(rb_external_str_new, x.data(), (long)x.size());
+      return stringToRuby(x.data(), (long)x.size(), this->returnInfo_);
     }
+
+  private:
+    Return* returnInfo_ = nullptr;
   };
 
   template<>
@@ -41,7 +50,7 @@ namespace Rice::detail
   public:
     From_Ruby() = default;
 
-    explicit From_Ruby(Arg* arg) : arg_(arg)
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<std::string_view>())
     {
     }
 
@@ -52,18 +61,52 @@ namespace Rice::detail
 
     std::string_view convert(VALUE value)
     {
-      if (value == Qnil && this->arg_ && this->arg_->hasDefaultValue())
+      if (value == Qnil && this->defaultValue_)
       {
-        return this->arg_->defaultValue<std::string_view>();
+        return *this->defaultValue_;
       }
       else
       {
-        detail::protect(rb_check_type, value, (int)T_STRING);
+        detail::checkString(value);
         return std::string_view(RSTRING_PTR(value), RSTRING_LEN(value));
       }
     }
 
   private:
-    Arg* arg_ = nullptr;
+    std::string_view* defaultValue_ = nullptr;
+  };
+
+  template<>
+  class From_Ruby<std::string_view&>
+  {
+  public:
+    From_Ruby() = default;
+
+    explicit From_Ruby(Arg* arg) : defaultValue_(arg->defaultValuePointer<std::string_view>())
+    {
+    }
+
+    bool is_convertible(VALUE value)
+    {
+      return rb_type(value) == RUBY_T_STRING;
+    }
+
+    std::string_view& convert(VALUE value)
+    {
+      if (value == Qnil && this->defaultValue_)
+      {
+        return *this->defaultValue_;
+      }
+      else
+      {
+        detail::checkString(value);
+        this->converted_ = std::string_view(RSTRING_PTR(value), RSTRING_LEN(value));
+        return this->converted_;
+      }
+    }
+
+  private:
+    std::string_view* defaultValue_ = nullptr;
+    std::string_view converted_;
   };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "../detail/to_ruby.hpp"
 #include "../detail/RubyFunction.hpp"
 #include "../Data_Type.hpp"
+#include "../ruby_memsize.hpp"
 
 #include <sstream>
 #include <stdexcept>
@@ -300,6 +301,25 @@ namespace Rice
       }
     };
 
+    template<typename T, typename U>
+    struct HeapSize<std::unordered_map<T, U>>
+    {
+      static size_t size(const std::unordered_map<T, U>& data)
+      {
+        // Elements are stored in singly linked nodes that may cache their hash code
+        size_t result = data.bucket_count() * sizeof(void*) +
+                        data.size() * (sizeof(typename std::unordered_map<T, U>::value_type) + 2 * sizeof(void*));
+        if constexpr (!std::is_scalar_v<T> || !std::is_scalar_v<U>)
+        {
+          for (const auto& pair : data)
+          {
+            result += elementHeapSize(pair.first) + elementHeapSize(pair.second);
+          }
+        }
+        return result;
+      }
+    };
+
     template<typename T, typename U>
     struct UnorderedMapFromHash
     {
@@ -335,7 +355,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::unordered_map<T, U>>())
       {
       }
 
@@ -358,9 +378,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::unordered_map<T, U>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -372,7 +392,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::unordered_map<T, U>* defaultValue_ = nullptr;
     };
 
     template<typename T, typename U>
@@ -381,7 +401,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::unordered_map<T, U>>())
       {
       }
 
@@ -405,9 +425,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::unordered_map<T, U>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -419,7 +439,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::unordered_map<T, U>* defaultValue_ = nullptr;
       std::unordered_map<T, U> converted_;
     };
 
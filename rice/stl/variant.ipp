@@ -1,3 +1,4 @@
+#include <array>
 #include <variant>
 
 namespace Rice::detail
@@ -103,85 +104,163 @@ namespace Rice::detail
     }
   };
 
+  /* Chooses which alternative of a variant a Ruby value is converted to. The first
+     alternative whose From_Ruby converter accepts the value wins. Finding it means calling
+     is_convertible on each alternative in turn, which for wide variants is a long chain of
+     rb_type and rb_obj_is_kind_of calls per argument.
+
+     The converters decide based on a value's builtin type or, for wrapped C++ objects, its
+     class. Thus the first lookup for a given builtin type or class is remembered in a table
+     so later values are dispatched with a single lookup. Classes are cached, instead of
+     the object's rb_data_type_t, because a derived C++ object returned through a base
+     pointer is wrapped with the base's data type but its own class. */
   template<typename...Types>
-  class From_Ruby<std::variant<Types...>>
+  class VariantDispatcher
   {
+  public:
+    static std::variant<Types...> convert(VALUE value);
+
   private:
-    // Possible converters we could use for this variant
-    using From_Ruby_Ts = std::tuple<From_Ruby<Types>...>;
+    static int lookup(VALUE value);
+    static int lookupClass(VALUE value);
 
-  public:
-    /* This method loops over each type in the variant, creates a From_Ruby converter,
-       and then check if the converter can work with the provided Rby value (it checks
-       the type of the Ruby object to see if it matches the variant type). 
-       If yes, then the converter runs. If no, then the method recursively calls itself
-       increasing the index. 
-       
-       We use recursion, with a constexpr, to avoid having to instantiate an instance
-       of the variant to store results from a fold expression like the To_Ruby code
-       does above. That allows us to process variants with non default constructible
-       arguments like std::reference_wrapper. */
-    template <std::size_t I = 0>
-    std::variant<Types...> convertInternal(VALUE value)
-    {
-      // Loop over each possible type in the variant.
-      if constexpr (I < std::variant_size_v<std::variant<Types...>>)
-      {
-        // Get the converter for the current index
-        typename std::tuple_element_t<I, From_Ruby_Ts> converter;
+    template<std::size_t... I>
+    static int findAlternative(VALUE value, std::index_sequence<I...>& indices);
 
-        // See if it will work
-        if (converter.is_convertible(value))
-        {
-          return converter.convert(value);
-        }
-        else
-        {
-          return convertInternal<I + 1>(value);
-        }
+    template<std::size_t I>
+    static std::variant<Types...> convertAlternative(VALUE value);
+
+    template<std::size_t I = 0>
+    static std::variant<Types...> convertIndex(int index, VALUE value);
+
+  private:
+    static_assert(sizeof...(Types) < 255, "Variant has too many alternatives");
+
+    // Entries store the index of the alternative plus one so that 0 means not yet looked up
+    inline static std::array<uint8_t, RUBY_T_MASK + 1> types_{};
+
+    static constexpr size_t ClassCount = 16;
+    inline static std::array<VALUE, ClassCount> classes_{};
+    inline static std::array<uint8_t, ClassCount> classIndexes_{};
+    inline static size_t classCount_ = 0;
+  };
+
+  template<typename...Types>
+  inline std::variant<Types...> VariantDispatcher<Types...>::convert(VALUE value)
+  {
+    return convertIndex(lookup(value), value);
+  }
+
+  template<typename...Types>
+  inline int VariantDispatcher<Types...>::lookup(VALUE value)
+  {
+    int type = rb_type(value);
+    if (type == RUBY_T_DATA)
+    {
+      return lookupClass(value);
+    }
+
+    uint8_t entry = types_[type];
+    if (RB_LIKELY(entry != 0))
+    {
+      return entry - 1;
+    }
+
+    auto indices = std::make_index_sequence<sizeof...(Types)>{};
+    int index = findAlternative(value, indices);
+    if (index >= 0)
+    {
+      types_[type] = (uint8_t)(index + 1);
+    }
+    return index;
+  }
+
+  template<typename...Types>
+  inline int VariantDispatcher<Types...>::lookupClass(VALUE value)
+  {
+    VALUE klass = call_unprotected(rb_obj_class, value);
+    for (size_t i = 0; i < classCount_; i++)
+    {
+      if (classes_[i] == klass)
+      {
+        return classIndexes_[i] - 1;
       }
-      throw std::runtime_error("Could not find converter for variant");
     }
 
-    std::variant<Types...> convert(VALUE value)
+    auto indices = std::make_index_sequence<sizeof...(Types)>{};
+    int index = findAlternative(value, indices);
+
+    // Once the table is full, further classes are looked up every time
+    if (index >= 0 && classCount_ < ClassCount)
     {
-      return convertInternal(value);
+      // The class is kept alive (and pinned) so its address cannot be reused by another class
+      rb_gc_register_address(&classes_[classCount_]);
+      classes_[classCount_] = klass;
+      classIndexes_[classCount_] = (uint8_t)(index + 1);
+      classCount_++;
     }
-  };
+
+    return index;
+  }
 
   template<typename...Types>
-  class From_Ruby<std::variant<Types...>&>
+  template<std::size_t... I>
+  inline int VariantDispatcher<Types...>::findAlternative(VALUE value, std::index_sequence<I...>& indices)
   {
-  private:
-    // Possible converters we could use for this variant
-    using From_Ruby_Ts = std::tuple<From_Ruby<Types>...>;
+    // Fold expression that stops at the first converter that accepts the value
+    int result = -1;
+    ((From_Ruby<std::variant_alternative_t<I, std::variant<Types...>>>().is_convertible(value) ?
+      (result = (int)I, true) : false) || ...);
+    return result;
+  }
 
-  public:
-    template <std::size_t I = 0>
-    std::variant<Types...> convertInternal(VALUE value)
+  template<typename...Types>
+  template<std::size_t I>
+  inline std::variant<Types...> VariantDispatcher<Types...>::convertAlternative(VALUE value)
+  {
+    From_Ruby<std::variant_alternative_t<I, std::variant<Types...>>> converter;
+    return std::variant<Types...>(std::in_place_index<I>, converter.convert(value));
+  }
+
+  template<typename...Types>
+  template<std::size_t I>
+  inline std::variant<Types...> VariantDispatcher<Types...>::convertIndex(int index, VALUE value)
+  {
+    // We use recursion, with a constexpr, instead of a fold expression to avoid having to
+    // instantiate an instance of the variant to store results. That allows us to process
+    // variants with non default constructible alternatives like std::reference_wrapper.
+    // Compilers turn this into a switch statement.
+    if constexpr (I < sizeof...(Types))
     {
-      // Loop over each possible type in the variant
-      if constexpr (I < std::variant_size_v<std::variant<Types...>>)
+      if (index == (int)I)
       {
-        // Get the converter for the current index
-        typename std::tuple_element_t<I, From_Ruby_Ts> converter;
-
-        // See if it will work
-        if (converter.is_convertible(value))
-        {
-          return converter.convert(value);
-        }
-        else
-        {
-          return convertInternal<I + 1>(value);
-        }
+        return convertAlternative<I>(value);
+      }
+      else
+      {
+        return convertIndex<I + 1>(index, value);
       }
-      throw std::runtime_error("Could not find converter for variant");
     }
+    throw std::runtime_error("Could not find converter for variant");
+  }
 
+  template<typename...Types>
+  class From_Ruby<std::variant<Types...>>
+  {
+  public:
+    std::variant<Types...> convert(VALUE value)
+    {
+      return VariantDispatcher<Types...>::convert(value);
+    }
+  };
+
+  template<typename...Types>
+  class From_Ruby<std::variant<Types...>&>
+  {
+  public:
     std::variant<Types...> convert(VALUE value)
     {
-      return convertInternal(value);
+      return VariantDispatcher<Types...>::convert(value);
     }
   };
 }
@@ -3,7 +3,9 @@
 #include "../detail/to_ruby.hpp"
 #include "../Data_Type.hpp"
 #include "../Data_Object.hpp"
+#include "../ruby_memsize.hpp"
 
+#include <climits>
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
@@ -376,16 +378,77 @@ namespace Rice
       }
     };
 
+    template<typename T>
+    struct HeapSize<std::vector<T>>
+    {
+      static size_t size(const std::vector<T>& data)
+      {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+          // std::vector<bool> stores one bit per element
+          return data.capacity() / CHAR_BIT;
+        }
+        else
+        {
+          size_t result = data.capacity() * sizeof(T);
+          if constexpr (!std::is_scalar_v<T>)
+          {
+            for (const T& element : data)
+            {
+              result += elementHeapSize(element);
+            }
+          }
+          return result;
+        }
+      }
+    };
+
     template<typename T>
     std::vector<T> vectorFromArray(VALUE value)
     {
-      long length = protect(rb_array_len, value);
-      std::vector<T> result(length);
+      long length = call_unprotected(rb_array_len, value);
+      std::vector<T> result;
+      result.reserve(length);
+
+      // Arrays of wrapped C++ objects are unwrapped directly, comparing each element's data
+      // type inline instead of creating a From_Ruby converter per element
+      using Intrinsic_T = intrinsic_type<T>;
+      if constexpr (std::is_class_v<Intrinsic_T> && (std::is_same_v<T, Intrinsic_T*> || std::is_same_v<T, Intrinsic_T>))
+      {
+        if (Data_Type<Intrinsic_T>::is_bound())
+        {
+          rb_data_type_t* rb_type = Data_Type<Intrinsic_T>::ruby_data_type();
+
+          // Unwrapping does not call back into Ruby so the array cannot change underneath us
+          const VALUE* elements = RARRAY_CONST_PTR(value);
+          for (long i = 0; i < length; i++)
+          {
+            VALUE element = elements[i];
+            Wrapper* wrapper = isTypedData(element, rb_type) ? getWrapper(element) : nullptr;
+
+            if (!wrapper)
+            {
+              // Let the regular converter deal with nil and raise errors
+              result.emplace_back(From_Ruby<T>().convert(element));
+            }
+            else if constexpr (std::is_pointer_v<T>)
+            {
+              result.emplace_back(static_cast<Intrinsic_T*>(wrapper->get()));
+            }
+            else
+            {
+              result.emplace_back(*static_cast<Intrinsic_T*>(wrapper->get()));
+            }
+          }
+
+          return result;
+        }
+      }
 
       for (long i = 0; i < length; i++)
       {
-        VALUE element = protect(rb_ary_entry, value, i);
-        result[i] = From_Ruby<T>().convert(element);
+        VALUE element = call_unprotected(rb_ary_entry, value, i);
+        result.emplace_back(From_Ruby<T>().convert(element));
       }
 
       return result;
@@ -397,7 +460,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::vector<T>>())
       {
       }
 
@@ -413,16 +476,16 @@ namespace Rice
           case T_ARRAY:
           {
             // If this an Ruby array and the vector type is copyable
-            if constexpr (std::is_default_constructible_v<T>)
+            if constexpr (std::is_copy_constructible_v<T> || std::is_default_constructible_v<T>)
             {
               return vectorFromArray<T>(value);
             }
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::vector<T>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -439,7 +502,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::vector<T>* defaultValue_ = nullptr;
     };
 
     template<typename T>
@@ -448,7 +511,7 @@ namespace Rice
     public:
       From_Ruby() = default;
 
-      explicit From_Ruby(Arg * arg) : arg_(arg)
+      explicit From_Ruby(Arg * arg) : defaultValue_(arg->template defaultValuePointer<std::vector<T>>())
       {
       }
 
@@ -464,7 +527,7 @@ namespace Rice
           case T_ARRAY:
           {
             // If this an Ruby array and the vector type is copyable
-            if constexpr (std::is_default_constructible_v<T>)
+            if constexpr (std::is_copy_constructible_v<T> || std::is_default_constructible_v<T>)
             {
               this->converted_ = vectorFromArray<T>(value);
               return this->converted_;
@@ -472,9 +535,9 @@ namespace Rice
           }
           case T_NIL:
           {
-            if (this->arg_ && this->arg_->hasDefaultValue())
+            if (this->defaultValue_)
             {
-              return this->arg_->template defaultValue<std::vector<T>>();
+              return *this->defaultValue_;
             }
           }
           default:
@@ -491,7 +554,7 @@ namespace Rice
       }
 
     private:
-      Arg* arg_ = nullptr;
+      std::vector<T>* defaultValue_ = nullptr;
       std::vector<T> converted_;
     };
 
@@ -511,7 +574,7 @@ namespace Rice
           case T_ARRAY:
           {
             // If this an Ruby array and the vector type is copyable
-            if constexpr (std::is_default_constructible_v<T>)
+            if constexpr (std::is_copy_constructible_v<T> || std::is_default_constructible_v<T>)
             {
               this->converted_ = vectorFromArray<T>(value);
               return &this->converted_;
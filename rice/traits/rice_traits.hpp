@@ -70,6 +70,16 @@ namespace Rice
     template<typename T>
     constexpr bool is_ostreamable_v = is_ostreamable<T>::value;
 
+    // Does the From_Ruby converter know how to check if a value is convertible? This is used to resolve overloads
+    template<typename T, typename = void>
+    struct has_is_convertible : std::false_type {};
+
+    template<typename T>
+    struct has_is_convertible<T, std::void_t<decltype(std::declval<T>().is_convertible(std::declval<VALUE>()))>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool has_is_convertible_v = has_is_convertible<T>::value;
+
     // Is the type comparable?
     template<typename T, typename SFINAE = void>
     struct is_comparable : std::false_type {};
@@ -93,6 +93,73 @@ TESTCASE(method_lambdas)
   ASSERT_EQUAL(o, result);
 }
 
+TESTCASE(alias_redefined_method)
+{
+  // This runs before many_methods uses up the slots so the methods are bound to slots
+  Class c(anonymous_class());
+  c.define_function("answer", [](int value)
+  {
+    return value * 2;
+  });
+  rb_define_alias(c, "old_answer", "answer");
+
+  // Redefine the method with a different arity and then define another method whose
+  // arity matches neither. The alias must still call the original function.
+  c.define_function("answer", []()
+  {
+    return 0;
+  });
+  c.define_function("other", [](int a, int b)
+  {
+    return a + b;
+  });
+
+  Object o = c.call("new");
+  ASSERT_EQUAL(42, detail::From_Ruby<int>().convert(o.call("old_answer", 21)));
+  ASSERT_EQUAL(0, detail::From_Ruby<int>().convert(o.call("answer")));
+  ASSERT_EQUAL(3, detail::From_Ruby<int>().convert(o.call("other", 1, 2)));
+}
+
+TESTCASE(many_methods)
+{
+  // Define more methods than there are native slots so that both trampolines
+  // and the registry lookup fallback are used
+  Class c(anonymous_class());
+  for (int i = 0; i < RICE_NATIVE_SLOTS + 100; i++)
+  {
+    c.define_function("function_" + std::to_string(i), [i]()
+    {
+      return i;
+    });
+  }
+
+  Object o = c.call("new");
+  for (int i = 0; i < RICE_NATIVE_SLOTS + 100; i++)
+  {
+    Object result = o.call("function_" + std::to_string(i));
+    ASSERT_EQUAL(i, detail::From_Ruby<int>().convert(result));
+  }
+}
+
+TESTCASE(redefine_methods)
+{
+  // Each redefinition claims a new slot, so this also runs past the last slot
+  // and into the registry lookup fallback
+  Class c(anonymous_class());
+  Object o = c.call("new");
+
+  for (int i = 0; i < 2 * RICE_NATIVE_SLOTS + 100; i++)
+  {
+    c.define_function("function", [i]()
+    {
+      return i;
+    });
+
+    Object result = o.call("function");
+    ASSERT_EQUAL(i, detail::From_Ruby<int>().convert(result));
+  }
+}
+
 TESTCASE(singleton_methods)
 {
   Class c(anonymous_class());
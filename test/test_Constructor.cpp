@@ -125,3 +125,37 @@ TESTCASE(constructor_supports_single_default_argument)
   klass.call("new", 6);
   ASSERT_EQUAL(6, withArgX);
 }
+
+namespace
+{
+  class Counted
+  {
+  public:
+    Counted()
+    {
+      live++;
+    }
+
+    ~Counted()
+    {
+      live--;
+    }
+
+    static inline int live = 0;
+  };
+}
+
+TESTCASE(emplace_wrong_type)
+{
+  define_class<Counted>("Counted")
+    .define_constructor(Constructor<Counted>());
+
+  // The object constructed for a value of the wrong type is destroyed
+  Counted::live = 0;
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    detail::emplace<Counted>(rb_str_new_cstr("counted"), Data_Type<Counted>::ruby_data_type()),
+    ASSERT_EQUAL(Object(rb_eTypeError), Object(CLASS_OF(ex.value())))
+  );
+  ASSERT_EQUAL(0, Counted::live);
+}
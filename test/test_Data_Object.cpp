@@ -189,6 +189,38 @@ TESTCASE(from_ruby_copy)
   ASSERT_EQUAL(myDataType->x, detail::From_Ruby<MyDataType>().convert(wrapped_foo).x);
 }
 
+TESTCASE(from_ruby_wrong_type)
+{
+  MyDataType* myDataType = new MyDataType;
+  Data_Object<MyDataType> wrapped_foo(myDataType);
+
+  ASSERT(!detail::From_Ruby<Bar*>().is_convertible(wrapped_foo));
+  ASSERT(!detail::From_Ruby<Bar*>().is_convertible(Qnil));
+  ASSERT(!detail::From_Ruby<Bar*>().is_convertible(rb_str_new2("bar")));
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    detail::From_Ruby<Bar*>().convert(wrapped_foo),
+    ASSERT_EQUAL("Wrong argument type. Expected: Bar. Received: MyDataType.", ex.what()));
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    detail::From_Ruby<Bar&>().convert(rb_str_new2("bar")),
+    ASSERT_EQUAL("Wrong argument type. Expected: Bar. Received: String.", ex.what()));
+}
+
+TESTCASE(from_ruby_ruby_subclass)
+{
+  Module m(rb_mKernel);
+  Object subclass = m.module_eval("Class.new(MyDataType)");
+
+  MyDataType* myDataType = new MyDataType;
+  VALUE wrapped_foo = detail::wrap(subclass, Data_Type<MyDataType>::ruby_data_type(), myDataType, true);
+
+  ASSERT(detail::From_Ruby<MyDataType*>().is_convertible(wrapped_foo));
+  ASSERT_EQUAL(myDataType, detail::From_Ruby<MyDataType*>().convert(wrapped_foo));
+}
+
 TESTCASE(ruby_custom_mark)
 {
   test_ruby_mark_called = false;
@@ -110,6 +110,27 @@ TESTCASE(return_base_pointer)
   ASSERT(rb_obj_is_instance_of(notification, rcPushNotification));
 }
 
+TESTCASE(return_base_pointer_after_bind)
+{
+  Class rcNotification = define_class<Notification>("Notification");
+  define_global_function("make_notification", &makeNotification);
+
+  Module m = define_module("Testing");
+
+  // EmailNotification is not bound yet so Rice falls back to the base class
+  Object notification = m.module_eval("make_notification(NotificationType::Email)");
+  ASSERT(rb_obj_is_instance_of(notification, rcNotification));
+
+  // Binding it has to invalidate the previous answer
+  Class rcEmailNotification = define_class<EmailNotification, Notification>("EmailNotification");
+  notification = m.module_eval("make_notification(NotificationType::Email)");
+  ASSERT(rb_obj_is_instance_of(notification, rcEmailNotification));
+
+  Data_Type<EmailNotification>::unbind();
+  notification = m.module_eval("make_notification(NotificationType::Email)");
+  ASSERT(rb_obj_is_instance_of(notification, rcNotification));
+}
+
 TESTCASE(base_pointer_method_call)
 {
   Class rcNotification = define_class<Notification>("Notification")
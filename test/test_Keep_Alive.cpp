@@ -55,6 +55,14 @@ namespace
   };
 }
 
+namespace Rice
+{
+  template<>
+  struct ruby_wb_protected<ListenerContainer> : std::true_type
+  {
+  };
+}
+
 SETUP(Keep_Alive)
 {
   embed_ruby();
@@ -96,6 +104,36 @@ TESTCASE(test_arg)
   ASSERT_EQUAL(INT2NUM(8), handler.call("process").value());
 }
 
+TESTCASE(test_arg_write_barrier)
+{
+  define_class<Listener>("Listener")
+    .define_constructor(Constructor<Listener>())
+    .define_method("get_value", &Listener::getValue);
+
+  define_class<ListenerContainer>("ListenerContainer")
+    .define_constructor(Constructor<ListenerContainer>())
+    .define_method("add_listener", &ListenerContainer::addListener, Arg("listener").keepAlive())
+    .define_method("process", &ListenerContainer::process);
+
+  Module m = define_module("TestingModule");
+  Object handler = m.module_eval("@handler = ListenerContainer.new");
+  ASSERT((RTYPEDDATA_TYPE(handler.value())->flags & RUBY_TYPED_WB_PROTECTED) != 0);
+
+  // Promote the handler to the old generation. Minor collections then only mark the
+  // young listeners if adding them fired write barriers.
+  m.module_eval("4.times { GC.start }");
+  m.module_eval(R"(@listeners = ObjectSpace::WeakMap.new
+                   100.times do |i|
+                     listener = Listener.new
+                     @listeners[i] = listener
+                     @handler.add_listener(listener)
+                   end)");
+
+  m.module_eval("GC.start(full_mark: false)");
+  ASSERT_EQUAL(100, detail::From_Ruby<int>().convert(m.module_eval("@listeners.keys.size").value()));
+  ASSERT_EQUAL(400, detail::From_Ruby<int>().convert(handler.call("process").value()));
+}
+
 namespace
 {
   class Connection; 
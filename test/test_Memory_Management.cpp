@@ -2,6 +2,9 @@
 #include "embed_ruby.hpp"
 #include <rice/rice.hpp>
 
+#include <iostream>
+#include <vector>
+
 using namespace Rice;
 
 TESTSUITE(Memory_Management);
@@ -47,3 +50,251 @@ TESTCASE(allows_copy_contructors_to_work)
   Object result = m.module_eval("return_test_class.tmp");
   ASSERT_EQUAL(8.0, detail::From_Ruby<double>().convert(result.value()));
 }
+
+namespace
+{
+  class Callback
+  {
+  public:
+    virtual ~Callback() = default;
+    virtual int call(int value) = 0;
+  };
+
+  class CallbackDirector : public Callback, public Director
+  {
+  public:
+    CallbackDirector(Object self) : Director(self)
+    {
+    }
+
+    int call(int value) override
+    {
+      return detail::From_Ruby<int>().convert(getSelf().call("call", value));
+    }
+
+    int default_call(int value)
+    {
+      raisePureVirtual();
+      return 0;
+    }
+  };
+
+  class CallbackList
+  {
+  public:
+    void add(Callback* callback)
+    {
+      this->callbacks_.push_back(callback);
+    }
+
+    Callback* first()
+    {
+      return this->callbacks_.front();
+    }
+
+    int run(int value)
+    {
+      int result = 0;
+      for (Callback* callback : this->callbacks_)
+      {
+        result += callback->call(value);
+      }
+      return result;
+    }
+
+  private:
+    std::vector<Callback*> callbacks_;
+  };
+
+  // Turns on the instance registry and restores its previous state when destroyed
+  class EnableTracking
+  {
+  public:
+    EnableTracking() : isEnabled_(detail::Registries::instance.instances.isEnabled)
+    {
+      detail::Registries::instance.instances.isEnabled = true;
+    }
+
+    ~EnableTracking()
+    {
+      detail::Registries::instance.instances.isEnabled = this->isEnabled_;
+    }
+
+  private:
+    bool isEnabled_;
+  };
+}
+
+TESTCASE(gc_compaction)
+{
+  Module m = define_module("TestingModule");
+  if (!m.module_eval("GC.respond_to?(:verify_compaction_references)").test())
+  {
+    std::cout << "(skipped, GC.verify_compaction_references is not available) ";
+    return;
+  }
+
+  define_class<Callback>("Callback")
+    .define_director<CallbackDirector>()
+    .define_constructor(Constructor<CallbackDirector, Object>())
+    .define_method("call", &CallbackDirector::default_call);
+
+  define_class<CallbackList>("CallbackList")
+    .define_constructor(Constructor<CallbackList>())
+    .define_method("add", &CallbackList::add, Arg("callback").keepAlive())
+    .define_method("first", &CallbackList::first)
+    .define_method("run", &CallbackList::run);
+
+  EnableTracking enableTracking;
+
+  // The callbacks are only referenced by the list's keep alive references and
+  // their Directors, so compaction is free to move them
+  m.module_eval(R"(class DoubleCallback < Callback
+                     def call(value)
+                       value * 2
+                     end
+                   end
+
+                   $callbacks = CallbackList.new
+                   100.times { $callbacks.add(DoubleCallback.new) }
+                   $first_id = $callbacks.first.object_id)");
+
+  m.module_eval(R"(if RUBY_VERSION >= "3.2"
+                     GC.verify_compaction_references(expand_heap: true, toward: :empty)
+                   else
+                     GC.verify_compaction_references(double_heap: true, toward: :empty)
+                   end)");
+
+  ASSERT_EQUAL(200, detail::From_Ruby<int>().convert(m.module_eval("$callbacks.run(1)")));
+  ASSERT(m.module_eval("$callbacks.first.object_id == $first_id").test());
+}
+
+namespace
+{
+  class ValueHolder
+  {
+  public:
+    void set(VALUE value)
+    {
+      this->value_ = value;
+    }
+
+    VALUE get()
+    {
+      return this->value_;
+    }
+
+  private:
+    VALUE value_ = Qnil;
+  };
+}
+
+TESTCASE(gc_compaction_keep_alive_value)
+{
+  Module m = define_module("TestingModule");
+  if (!m.module_eval("GC.respond_to?(:verify_compaction_references)").test())
+  {
+    std::cout << "(skipped, GC.verify_compaction_references is not available) ";
+    return;
+  }
+
+  define_class<ValueHolder>("ValueHolder")
+    .define_constructor(Constructor<ValueHolder>())
+    .define_method("set", &ValueHolder::set, Arg("value").setValue().keepAlive())
+    .define_method("get", &ValueHolder::get, Return().setValue());
+
+  // The string is only referenced by the holder's keep alive reference and the VALUE
+  // stored in C++, so compaction must not move it
+  m.module_eval(R"($holder = ValueHolder.new
+                   $holder.set("kept alive " * 10))");
+
+  m.module_eval(R"(if RUBY_VERSION >= "3.2"
+                     GC.verify_compaction_references(expand_heap: true, toward: :empty)
+                   else
+                     GC.verify_compaction_references(double_heap: true, toward: :empty)
+                   end)");
+
+  ASSERT(m.module_eval(R"($holder.get == "kept alive " * 10)").test());
+}
+
+namespace
+{
+  class Buffer
+  {
+  public:
+    Buffer(size_t size) : data_(size)
+    {
+    }
+
+    size_t capacity() const
+    {
+      return this->data_.capacity();
+    }
+
+    void grow(size_t size)
+    {
+      this->data_.resize(this->data_.size() + size);
+    }
+
+  private:
+    std::vector<char> data_;
+  };
+}
+
+namespace Rice
+{
+  template<>
+  size_t ruby_memsize(const Buffer* buffer)
+  {
+    return sizeof(Buffer) + buffer->capacity();
+  }
+
+  template<>
+  struct ruby_adjust_memory_usage<Buffer> : std::true_type
+  {
+  };
+}
+
+TESTCASE(memsize)
+{
+  define_class<Buffer>("Buffer")
+    .define_constructor(Constructor<Buffer, size_t>());
+
+  Module m = define_module("TestingModule");
+  m.module_eval("require 'objspace'");
+
+  size_t size = detail::From_Ruby<size_t>().convert(m.module_eval("ObjectSpace.memsize_of(Buffer.new(100_000))"));
+  ASSERT((size >= 100'000));
+}
+
+TESTCASE(adjust_memory_usage)
+{
+  define_class<Buffer>("Buffer")
+    .define_constructor(Constructor<Buffer, size_t>());
+
+  Module m = define_module("TestingModule");
+
+  // Only a few small objects are allocated, so Ruby only runs the garbage collector if
+  // it knows about the memory used by the buffers. Ruby checks the amount of memory
+  // allocated when it next allocates memory itself, such as for the string.
+  std::string code = R"(GC.start
+                        count = GC.count
+                        100.times { Buffer.new(1_000_000); "a" * 1000 }
+                        GC.count > count)";
+  ASSERT(m.module_eval(code).test());
+}
+
+TESTCASE(adjust_memory_usage_balanced)
+{
+  // The buffer grows after Ruby was told about it, but freeing it only subtracts
+  // what was reported when it was created
+  VALUE key = ID2SYM(rb_intern("malloc_increase_bytes"));
+  size_t allocated = 0;
+  {
+    detail::WrapperValue<Buffer> wrapper(std::in_place, 1000);
+    static_cast<Buffer*>(wrapper.get())->grow(10'000'000);
+    allocated = rb_gc_stat(key);
+  }
+  size_t freed = allocated - rb_gc_stat(key);
+  ASSERT_EQUAL(sizeof(Buffer) + 1000, freed);
+}
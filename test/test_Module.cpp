@@ -190,6 +190,14 @@ TESTCASE(method_int_passed_no_args)
       );
 }
 
+TESTCASE(method_int_arity)
+{
+  Module m(anonymous_module());
+  m.define_method("foo", method_int);
+  Object result = m.module_eval("instance_method(:foo).arity");
+  ASSERT_EQUAL(1, detail::From_Ruby<int>().convert(result));
+}
+
 TESTCASE(define_singleton_method_int_foo)
 {
   Module m(anonymous_module());
@@ -281,6 +289,29 @@ TESTCASE(default_arguments_still_throws_argument_error)
       );
 }
 
+TESTCASE(default_arguments_arity)
+{
+  Module m(anonymous_module());
+  m.define_function("foo", &defaults_method_one, Arg("arg1"), Arg("arg2") = 3, Arg("arg3") = true);
+  m.define_function("bar", &defaults_method_one, Arg("arg1"), Arg("arg2"), Arg("arg3"));
+
+  Object result = m.module_eval("instance_method(:foo).arity");
+  ASSERT_EQUAL(-1, detail::From_Ruby<int>().convert(result));
+
+  result = m.module_eval("instance_method(:bar).arity");
+  ASSERT_EQUAL(3, detail::From_Ruby<int>().convert(result));
+}
+
+TESTCASE(default_argument_type_mismatch)
+{
+  // Defaults are checked against the parameter type when the method is defined
+  Module m(anonymous_module());
+  ASSERT_EXCEPTION(
+    std::bad_any_cast,
+    m.define_function("foo", &defaults_method_one, Arg("arg1"), Arg("arg2") = 3.5, Arg("arg3") = true)
+  );
+}
+
 namespace {
   int the_one_default_arg = 0;
   void method_with_one_default_arg(int num = 4) {
@@ -361,6 +392,73 @@ TESTCASE(default_arguments_for_define_module_function)
   ASSERT(!defaults_method_one_arg3);
 }
 
+// Tests for keyword arguments
+TESTCASE(keyword_arguments)
+{
+  Module m(anonymous_module());
+  m.define_module_function("foo", &defaults_method_one, Arg("arg1"), Arg("arg2").keyword(), Arg("arg3").keyword() = true);
+
+  m.module_eval("foo(1, arg2: 2)");
+
+  ASSERT_EQUAL(1, defaults_method_one_arg1);
+  ASSERT_EQUAL(2, defaults_method_one_arg2);
+  ASSERT(defaults_method_one_arg3);
+
+  m.module_eval("foo(3, arg3: false, arg2: 4)");
+
+  ASSERT_EQUAL(3, defaults_method_one_arg1);
+  ASSERT_EQUAL(4, defaults_method_one_arg2);
+  ASSERT(!defaults_method_one_arg3);
+
+  Object result = m.module_eval("instance_method(:foo).arity");
+  ASSERT_EQUAL(-1, detail::From_Ruby<int>().convert(result));
+}
+
+TESTCASE(keyword_arguments_before_positional)
+{
+  Module m(anonymous_module());
+  m.define_module_function("foo", &defaults_method_one, Arg("arg1").keyword() = 5, Arg("arg2"), Arg("arg3") = false);
+
+  m.module_eval("foo(6)");
+
+  ASSERT_EQUAL(5, defaults_method_one_arg1);
+  ASSERT_EQUAL(6, defaults_method_one_arg2);
+  ASSERT(!defaults_method_one_arg3);
+
+  m.module_eval("foo(7, true, arg1: 8)");
+
+  ASSERT_EQUAL(8, defaults_method_one_arg1);
+  ASSERT_EQUAL(7, defaults_method_one_arg2);
+  ASSERT(defaults_method_one_arg3);
+}
+
+TESTCASE(keyword_arguments_throw_argument_error)
+{
+  Module m(anonymous_module());
+  m.define_module_function("foo", &defaults_method_one, Arg("arg1"), Arg("arg2").keyword(), Arg("arg3").keyword() = true);
+
+  // Missing required keyword
+  ASSERT_EXCEPTION_CHECK(
+      Exception,
+      m.module_eval("foo(1)"),
+      ASSERT_EQUAL(Object(rb_eArgError), Object(CLASS_OF(ex.value())))
+      );
+
+  // Unknown keyword
+  ASSERT_EXCEPTION_CHECK(
+      Exception,
+      m.module_eval("foo(1, arg2: 2, arg4: 3)"),
+      ASSERT_EQUAL(Object(rb_eArgError), Object(CLASS_OF(ex.value())))
+      );
+
+  // Keyword passed positionally
+  ASSERT_EXCEPTION_CHECK(
+      Exception,
+      m.module_eval("foo(1, 2)"),
+      ASSERT_EQUAL(Object(rb_eArgError), Object(CLASS_OF(ex.value())))
+      );
+}
+
 namespace {
   std::string with_defaults_and_references_x;
   bool with_defaults_and_references_doIt;
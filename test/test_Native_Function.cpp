@@ -0,0 +1,260 @@
+#include <cstdlib>
+#include <new>
+
+#include "unittest.hpp"
+#include "embed_ruby.hpp"
+#include <rice/rice.hpp>
+
+using namespace Rice;
+
+TESTSUITE(NativeFunction);
+
+// Count C++ heap allocations so we can verify that calling a wrapped
+// function does not allocate. Ruby itself allocates with malloc so
+// only allocations made by Rice (or the wrapped code) are counted.
+// The replacement operators are global, so they are used by the whole
+// unittest binary and not just by these tests. Allocations are only
+// counted on the current thread while an AllocationCounter is alive,
+// everywhere else operator new behaves like the default one. With gcc the
+// replacements are not inlined so the compiler does not mistake the
+// malloc and free inside them for mismatched calls.
+#ifdef __GNUC__
+#define TEST_NOINLINE __attribute__((noinline))
+#else
+#define TEST_NOINLINE
+#endif
+
+namespace
+{
+  class AllocationCounter
+  {
+  public:
+    AllocationCounter()
+    {
+      active_ = this;
+    }
+
+    ~AllocationCounter()
+    {
+      active_ = nullptr;
+    }
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    size_t count() const
+    {
+      return this->count_;
+    }
+
+    static void record()
+    {
+      if (active_)
+      {
+        active_->count_++;
+      }
+    }
+
+  private:
+    static inline thread_local AllocationCounter* active_ = nullptr;
+    size_t count_ = 0;
+  };
+}
+
+TEST_NOINLINE void* operator new(std::size_t size)
+{
+  AllocationCounter::record();
+
+  if (void* result = std::malloc(size ? size : 1))
+  {
+    return result;
+  }
+  throw std::bad_alloc();
+}
+
+TEST_NOINLINE void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+TEST_NOINLINE void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+TEST_NOINLINE void operator delete[](void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+TEST_NOINLINE void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+TEST_NOINLINE void operator delete[](void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+namespace
+{
+  class Accumulator
+  {
+  public:
+    int add(int a, int b)
+    {
+      this->total += a + b;
+      return this->total;
+    }
+
+    double scale(double value, double factor = 2.0)
+    {
+      return value * factor;
+    }
+
+    int total = 0;
+  };
+
+  int sum(int a, int b, int c)
+  {
+    return a + b + c;
+  }
+
+  struct Matrix
+  {
+    double values[16];
+  };
+
+  Matrix identity(double scale)
+  {
+    Matrix result{};
+    for (int i = 0; i < 4; i++)
+    {
+      result.values[i * 5] = scale;
+    }
+    return result;
+  }
+
+  Matrix& transpose(Matrix* matrix)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = i + 1; j < 4; j++)
+      {
+        std::swap(matrix->values[i * 4 + j], matrix->values[j * 4 + i]);
+      }
+    }
+    return *matrix;
+  }
+
+  size_t countCallAllocations(VALUE receiver, const char* name, int argc, const VALUE* argv, int kw_splat = RB_NO_KEYWORDS)
+  {
+    ID id = rb_intern(name);
+
+    // Warm up
+    rb_funcallv_kw(receiver, id, argc, argv, kw_splat);
+
+    AllocationCounter counter;
+    for (int i = 0; i < 1000; i++)
+    {
+      rb_funcallv_kw(receiver, id, argc, argv, kw_splat);
+    }
+
+    return counter.count();
+  }
+}
+
+SETUP(NativeFunction)
+{
+  embed_ruby();
+}
+
+TESTCASE(call_does_not_allocate)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("sum", &sum);
+
+  VALUE args[] = { INT2NUM(1), INT2NUM(2), INT2NUM(3) };
+  ASSERT_EQUAL(0u, countCallAllocations(m.value(), "sum", 3, args));
+}
+
+TESTCASE(method_call_does_not_allocate)
+{
+  Data_Type<Accumulator> c = define_class<Accumulator>("Accumulator")
+    .define_constructor(Constructor<Accumulator>())
+    .define_method("add", &Accumulator::add);
+
+  Object accumulator = c.call("new");
+
+  VALUE args[] = { INT2NUM(1), INT2NUM(2) };
+  ASSERT_EQUAL(0u, countCallAllocations(accumulator.value(), "add", 2, args));
+  ASSERT_EQUAL(3003, detail::From_Ruby<Accumulator*>().convert(accumulator.value())->total);
+}
+
+TESTCASE(default_arguments_do_not_allocate)
+{
+  Data_Type<Accumulator> c = define_class<Accumulator>("Accumulator")
+    .define_constructor(Constructor<Accumulator>())
+    .define_method("scale", &Accumulator::scale, Arg("value"), Arg("factor") = 2.0);
+
+  Object accumulator = c.call("new");
+
+  VALUE args[] = { rb_float_new(1.5), rb_float_new(3.0) };
+  ASSERT_EQUAL(0u, countCallAllocations(accumulator.value(), "scale", 1, args));
+  ASSERT_EQUAL(0u, countCallAllocations(accumulator.value(), "scale", 2, args));
+}
+
+TESTCASE(keyword_arguments_do_not_allocate)
+{
+  Data_Type<Accumulator> c = define_class<Accumulator>("Accumulator")
+    .define_constructor(Constructor<Accumulator>())
+    .define_method("scale", &Accumulator::scale, Arg("value"), Arg("factor").keyword() = 2.0);
+
+  Object accumulator = c.call("new");
+
+  VALUE keywords = rb_hash_new();
+  rb_hash_aset(keywords, ID2SYM(rb_intern("factor")), rb_float_new(3.0));
+
+  VALUE args[] = { rb_float_new(1.5), keywords };
+  ASSERT_EQUAL(0u, countCallAllocations(accumulator.value(), "scale", 1, args));
+  ASSERT_EQUAL(0u, countCallAllocations(accumulator.value(), "scale", 2, args, RB_PASS_KEYWORDS));
+}
+
+TESTCASE(constructor_allocates_once)
+{
+  Data_Type<Accumulator> c = define_class<Accumulator>("Accumulator")
+    .define_constructor(Constructor<Accumulator>());
+
+  // The Accumulator is stored inside its wrapper, so each new only allocates once
+  ASSERT_EQUAL(1000u, countCallAllocations(c.value(), "new", 0, nullptr));
+}
+
+TESTCASE(return_value_allocates_once)
+{
+  define_class<Matrix>("Matrix");
+
+  Module m = define_module("Testing");
+  m.define_module_function("identity", &identity);
+
+  VALUE args[] = { rb_float_new(1.0) };
+  ASSERT_EQUAL(1000u, countCallAllocations(m.value(), "identity", 1, args));
+}
+
+TESTCASE(protect_does_not_allocate)
+{
+  // Matrix is too large for any small buffer optimization
+  Matrix matrix;
+  Matrix* transposed = nullptr;
+  size_t allocations = 0;
+  {
+    AllocationCounter counter;
+    matrix = detail::protect(identity, -1.0);
+    transposed = &detail::protect(transpose, &matrix);
+    allocations = counter.count();
+  }
+
+  ASSERT_EQUAL(0u, allocations);
+  ASSERT_EQUAL(-1.0, matrix.values[15]);
+  ASSERT_EQUAL(&matrix, transposed);
+}
@@ -0,0 +1,97 @@
+#include "unittest.hpp"
+#include "embed_ruby.hpp"
+#include <rice/rice.hpp>
+
+using namespace Rice;
+
+TESTSUITE(NativeRegistry);
+
+SETUP(NativeRegistry)
+{
+  embed_ruby();
+}
+
+namespace
+{
+  class MyNative : public detail::Native
+  {
+  public:
+    VALUE operator()(int argc, VALUE* argv, VALUE self) override
+    {
+      return Qnil;
+    }
+  };
+}
+
+TESTCASE(lookup)
+{
+  detail::NativeRegistry registry;
+  Class c = anonymous_class();
+  ID id = Identifier("foo").id();
+
+  MyNative native;
+  registry.add(c, id, &native);
+
+  ASSERT_EQUAL(&native, registry.lookup(c, id));
+  ASSERT_EQUAL((detail::Native*)nullptr, registry.lookup(c, Identifier("bar").id()));
+  ASSERT_EQUAL((detail::Native*)nullptr, registry.lookup(anonymous_class(), id));
+}
+
+TESTCASE(replace)
+{
+  detail::NativeRegistry registry;
+  Class c = anonymous_class();
+  ID id = Identifier("foo").id();
+
+  MyNative native1;
+  registry.add(c, id, &native1);
+
+  MyNative native2;
+  registry.add(c, id, &native2);
+
+  ASSERT_EQUAL(&native2, registry.lookup(c, id));
+}
+
+TESTCASE(no_collisions)
+{
+  // These keys hashed to the same value with the registry's original
+  // (53 + klass) * 53 + id hash function
+  Class c1 = anonymous_class();
+  Class c2 = anonymous_class();
+  VALUE klass1 = std::max(c1.value(), c2.value());
+  VALUE klass2 = std::min(c1.value(), c2.value());
+
+  ID id1 = Identifier("foo").id();
+  ID id2 = id1 + 53 * (klass1 - klass2);
+  ASSERT_EQUAL((53 + klass1) * 53 + id1, (53 + klass2) * 53 + id2);
+
+  detail::NativeRegistry registry;
+  MyNative native1;
+  MyNative native2;
+  registry.add(klass1, id1, &native1);
+  registry.add(klass2, id2, &native2);
+
+  ASSERT_EQUAL(&native1, registry.lookup(klass1, id1));
+  ASSERT_EQUAL(&native2, registry.lookup(klass2, id2));
+}
+
+TESTCASE(many_natives)
+{
+  detail::NativeRegistry registry;
+  std::vector<Class> klasses = { anonymous_class(), anonymous_class(), anonymous_class() };
+
+  const int count = 12000;
+  std::vector<MyNative> natives(count);
+
+  for (int i = 0; i < count; i++)
+  {
+    ID id = Identifier("method_" + std::to_string(i / klasses.size())).id();
+    registry.add(klasses[i % klasses.size()], id, &natives[i]);
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    ID id = Identifier("method_" + std::to_string(i / klasses.size())).id();
+    ASSERT_EQUAL(&natives[i], registry.lookup(klasses[i % klasses.size()], id));
+  }
+}
@@ -0,0 +1,212 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "unittest.hpp"
+#include "embed_ruby.hpp"
+#include <rice/rice.hpp>
+#include <rice/stl.hpp>
+
+using namespace Rice;
+
+TESTSUITE(NoGVL);
+
+SETUP(NoGVL)
+{
+  embed_ruby();
+}
+
+namespace
+{
+  // A task checks whether it holds the GVL by waiting for another Ruby thread to
+  // make progress, which that thread can only do if the GVL was released
+  std::atomic<bool> started = false;
+  std::atomic<bool> running = false;
+  std::atomic<bool> progressed = false;
+
+  bool otherThreadRan()
+  {
+    progressed = false;
+    running = true;
+    started = true;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (!progressed && std::chrono::steady_clock::now() < deadline)
+    {
+      std::this_thread::yield();
+    }
+
+    running = false;
+    return progressed;
+  }
+
+  bool task_started()
+  {
+    return started;
+  }
+
+  void task_progress()
+  {
+    if (running)
+    {
+      progressed = true;
+    }
+  }
+
+  // Calls method on object while another Ruby thread tries to make progress
+  Object callWithOtherThread(Object object, const char* method)
+  {
+    started = false;
+    define_global_function("task_started?", &task_started);
+    define_global_function("task_progress", &task_progress);
+
+    std::string code = std::string(R"(
+      thread = Thread.new do
+        Thread.pass until task_started?
+        task_progress
+      end
+      result = )") + method + R"(
+      thread.join
+      result)";
+
+    return object.instance_eval(code);
+  }
+
+  class Task
+  {
+  public:
+    int run(int value)
+    {
+      this->hadGVL = !otherThreadRan();
+      return value * 2;
+    }
+
+    std::string& name()
+    {
+      this->hadGVL = !otherThreadRan();
+      return this->name_;
+    }
+
+    void fail()
+    {
+      throw std::invalid_argument("task failed");
+    }
+
+    bool hadGVL = true;
+
+  private:
+    std::string name_ = "task";
+  };
+
+  // Waits until two threads are running echo at the same time, so both of their
+  // arguments have been converted before either returns
+  std::atomic<int> echoing = 0;
+
+  std::string echo(const std::string& value)
+  {
+    echoing++;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (echoing < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+      std::this_thread::yield();
+    }
+
+    return value;
+  }
+
+  std::atomic<bool> cancelled = false;
+
+  void cancel(void*)
+  {
+    cancelled = true;
+  }
+
+  void spin()
+  {
+    while (!cancelled)
+    {
+    }
+  }
+}
+
+TESTCASE(method_without_gvl)
+{
+  Data_Type<Task> c = define_class<Task>("Task")
+    .define_constructor(Constructor<Task>())
+    .define_method("run", &Task::run, NoGVL())
+    .define_method("name", &Task::name, NoGVL());
+
+  Object object = c.call("new");
+  Task* task = detail::From_Ruby<Task*>().convert(object);
+
+  ASSERT_EQUAL(42, detail::From_Ruby<int>().convert(callWithOtherThread(object, "run(21)")));
+  ASSERT(!task->hadGVL);
+
+  task->hadGVL = true;
+  ASSERT_EQUAL("task", detail::From_Ruby<std::string>().convert(callWithOtherThread(object, "name")));
+  ASSERT(!task->hadGVL);
+}
+
+TESTCASE(method_with_gvl)
+{
+  Data_Type<Task> c = define_class<Task>("Task")
+    .define_constructor(Constructor<Task>())
+    .define_method("run", &Task::run);
+
+  Object object = c.call("new");
+  Task* task = detail::From_Ruby<Task*>().convert(object);
+
+  ASSERT_EQUAL(42, detail::From_Ruby<int>().convert(callWithOtherThread(object, "run(21)")));
+  ASSERT(task->hadGVL);
+}
+
+TESTCASE(exception_without_gvl)
+{
+  Data_Type<Task> c = define_class<Task>("Task")
+    .define_constructor(Constructor<Task>())
+    .define_method("fail", &Task::fail, NoGVL());
+
+  Object object = c.call("new");
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    object.call("fail"),
+    ASSERT_EQUAL(Object(rb_eArgError), Object(CLASS_OF(ex.value())))
+  );
+}
+
+TESTCASE(unblocking_function)
+{
+  Module m(anonymous_module());
+  m.define_module_function("spin", &spin, NoGVL(cancel));
+
+  // Killing the thread calls the unblocking function, which makes spin return
+  cancelled = false;
+  Object result = m.instance_eval(R"(
+    thread = Thread.new { spin }
+    sleep 0.01 until thread.status == "sleep"
+    thread.kill
+    thread.join(5)
+    thread.status)");
+
+  ASSERT(cancelled);
+  ASSERT_EQUAL(Qfalse, result.value());
+}
+
+TESTCASE(concurrent_calls)
+{
+  Module m(anonymous_module());
+  m.define_module_function("echo", &echo, NoGVL());
+
+  // Each call must keep its own converted argument while the other call runs
+  echoing = 0;
+  Array result = m.instance_eval(R"(
+    threads = [Thread.new { echo("a" * 100) }, Thread.new { echo("b" * 200) }]
+    threads.map(&:value))");
+
+  ASSERT_EQUAL(2, echoing.load());
+  ASSERT_EQUAL(std::string(100, 'a'), detail::From_Ruby<std::string>().convert(result[0].value()));
+  ASSERT_EQUAL(std::string(200, 'b'), detail::From_Ruby<std::string>().convert(result[1].value()));
+}
@@ -0,0 +1,188 @@
+#include "unittest.hpp"
+#include "embed_ruby.hpp"
+#include <rice/rice.hpp>
+#include <rice/stl.hpp>
+
+using namespace Rice;
+
+TESTSUITE(Overloads);
+
+SETUP(Overloads)
+{
+  embed_ruby();
+}
+
+namespace
+{
+  std::string run(int value)
+  {
+    return "int: " + std::to_string(value);
+  }
+
+  std::string run(std::string value)
+  {
+    return "string: " + value;
+  }
+
+  std::string run(double value, int times = 2)
+  {
+    return "double: " + std::to_string((int)(value * times));
+  }
+
+  class Widget
+  {
+  public:
+    std::string describe()
+    {
+      return "no args";
+    }
+
+    std::string describe(int value)
+    {
+      return "int " + std::to_string(value);
+    }
+
+    std::string describe(int value, bool flag)
+    {
+      return "int " + std::to_string(value) + (flag ? " true" : " false");
+    }
+  };
+
+  class Gadget
+  {
+  };
+
+  std::string process(Widget* widget)
+  {
+    return "widget";
+  }
+
+  std::string process(Gadget* gadget)
+  {
+    return "gadget";
+  }
+}
+
+TESTCASE(functions)
+{
+  Module m(anonymous_module());
+  m.define_module_function<std::string(*)(int)>("run", &run);
+  m.define_module_function<std::string(*)(std::string)>("run", &run, Overload());
+  m.define_module_function<std::string(*)(double, int)>("run", &run, Arg("value"), Arg("times") = 2, Overload());
+
+  ASSERT_EQUAL("int: 3", detail::From_Ruby<std::string>().convert(m.call("run", 3)));
+  ASSERT_EQUAL("string: three", detail::From_Ruby<std::string>().convert(m.call("run", "three")));
+  ASSERT_EQUAL("double: 3", detail::From_Ruby<std::string>().convert(m.call("run", 1.5)));
+  ASSERT_EQUAL("double: 6", detail::From_Ruby<std::string>().convert(m.call("run", 1.5, 4)));
+
+  Object result = m.instance_eval("method(:run).arity");
+  ASSERT_EQUAL(-1, detail::From_Ruby<int>().convert(result));
+}
+
+TESTCASE(methods)
+{
+  Data_Type<Widget> c = define_class<Widget>("Widget")
+    .define_constructor(Constructor<Widget>())
+    .define_method<std::string(Widget::*)()>("describe", &Widget::describe)
+    .define_method<std::string(Widget::*)(int)>("describe", &Widget::describe, Overload())
+    .define_method<std::string(Widget::*)(int, bool)>("describe", &Widget::describe, Overload());
+
+  Object widget = c.call("new");
+  ASSERT_EQUAL("no args", detail::From_Ruby<std::string>().convert(widget.call("describe")));
+  ASSERT_EQUAL("int 1", detail::From_Ruby<std::string>().convert(widget.call("describe", 1)));
+  ASSERT_EQUAL("int 2 true", detail::From_Ruby<std::string>().convert(widget.call("describe", 2, true)));
+}
+
+TESTCASE(wrapped_types)
+{
+  define_class<Widget>("Widget")
+    .define_constructor(Constructor<Widget>());
+
+  define_class<Gadget>("Gadget")
+    .define_constructor(Constructor<Gadget>());
+
+  Module m(anonymous_module());
+  m.define_module_function<std::string(*)(Widget*)>("process", &process);
+  m.define_module_function<std::string(*)(Gadget*)>("process", &process, Overload());
+
+  Object result = m.instance_eval("process(Gadget.new)");
+  ASSERT_EQUAL("gadget", detail::From_Ruby<std::string>().convert(result));
+
+  result = m.instance_eval("process(Widget.new)");
+  ASSERT_EQUAL("widget", detail::From_Ruby<std::string>().convert(result));
+}
+
+TESTCASE(cached_resolution)
+{
+  Module m(anonymous_module());
+  m.define_module_function<std::string(*)(int)>("run", &run);
+  m.define_module_function<std::string(*)(std::string)>("run", &run, Overload());
+
+  // Alternate between argument types so the inline cache keeps missing and hitting
+  Array results = m.instance_eval("[1, 2, 'a', 'b', 3].map { |value| run(value) }");
+  ASSERT_EQUAL("int: 1", detail::From_Ruby<std::string>().convert(results[0].value()));
+  ASSERT_EQUAL("int: 2", detail::From_Ruby<std::string>().convert(results[1].value()));
+  ASSERT_EQUAL("string: a", detail::From_Ruby<std::string>().convert(results[2].value()));
+  ASSERT_EQUAL("string: b", detail::From_Ruby<std::string>().convert(results[3].value()));
+  ASSERT_EQUAL("int: 3", detail::From_Ruby<std::string>().convert(results[4].value()));
+}
+
+TESTCASE(redefinition_replaces)
+{
+  // Without Overload() a function replaces the existing method even if its parameters differ
+  Module m(anonymous_module());
+  m.define_module_function<std::string(*)(int)>("run", &run);
+  m.define_module_function<std::string(*)(std::string)>("run", &run);
+
+  ASSERT_EQUAL("string: three", detail::From_Ruby<std::string>().convert(m.call("run", "three")));
+
+  Object result = m.instance_eval("method(:run).arity");
+  ASSERT_EQUAL(1, detail::From_Ruby<int>().convert(result));
+}
+
+TESTCASE(same_signature_replaces)
+{
+  Module m(anonymous_module());
+  m.define_module_function("answer", [](int value) { return value; });
+  m.define_module_function("answer", [](int value) { return value * 2; }, Overload());
+
+  ASSERT_EQUAL(42, detail::From_Ruby<int>().convert(m.call("answer", 21)));
+
+  // Still a regular method with a fixed arity, not an overload set
+  Object result = m.instance_eval("method(:answer).arity");
+  ASSERT_EQUAL(1, detail::From_Ruby<int>().convert(result));
+}
+
+TESTCASE(no_matching_overload)
+{
+  Module m(anonymous_module());
+  m.define_module_function<std::string(*)(int)>("run", &run);
+  m.define_module_function<std::string(*)(std::string)>("run", &run, Overload());
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    m.call("run", 1.5),
+    ASSERT_EQUAL(Object(rb_eArgError), Object(CLASS_OF(ex.value())))
+  );
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    m.call("run", 1, 2),
+    ASSERT_EQUAL(Object(rb_eArgError), Object(CLASS_OF(ex.value())))
+  );
+}
+
+TESTCASE(keywords_cannot_be_overloaded)
+{
+  Module m(anonymous_module());
+  m.define_module_function<std::string(*)(int)>("run", &run);
+
+  ASSERT_EXCEPTION_CHECK(
+    std::runtime_error,
+    m.define_module_function<std::string(*)(double, int)>("run", &run, Arg("value"), Arg("times").keyword() = 2, Overload()),
+    ASSERT(std::string(ex.what()).find("Cannot overload") == 0)
+  );
+
+  // The existing method is unchanged
+  ASSERT_EQUAL("int: 3", detail::From_Ruby<std::string>().convert(m.call("run", 3)));
+}
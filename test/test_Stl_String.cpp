@@ -75,3 +75,99 @@ TESTCASE(std_string_from_ruby_with_binary)
   ASSERT_EQUAL(5ul, got.length());
   ASSERT_EQUAL(std::string("\000test", 5), got);
 }
+
+TESTCASE(std_string_ref_from_ruby_releases_large_buffer)
+{
+  detail::From_Ruby<std::string&> fromRuby;
+
+  std::string large(100000, 'a');
+  std::string& converted = fromRuby.convert(rb_str_new(large.data(), large.size()));
+  ASSERT_EQUAL(large, converted);
+
+  // Converting a short string afterwards does not keep the large buffer
+  fromRuby.convert(rb_str_new2("short"));
+  ASSERT_EQUAL(std::string("short"), converted);
+  ASSERT((converted.capacity() < large.size()));
+
+  // Strings of a similar size reuse the buffer
+  std::string medium(10000, 'b');
+  fromRuby.convert(rb_str_new(medium.data(), medium.size()));
+  const char* buffer = converted.data();
+  fromRuby.convert(rb_str_new(medium.data(), medium.size() - 1));
+  ASSERT((buffer == converted.data()));
+}
+
+namespace
+{
+  std::string greeting()
+  {
+    return "h\xC3\xA9llo";
+  }
+}
+
+TESTCASE(std_string_return_encoding)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("greeting", &greeting);
+  m.define_module_function("greeting_binary", &greeting, Return().binary());
+  m.define_module_function("greeting_utf8", &greeting, Return().utf8());
+
+  String binary = m.call("greeting_binary");
+  ASSERT_EQUAL("ASCII-8BIT", binary.call("encoding").call("name").to_s().str());
+  ASSERT_EQUAL(6u, binary.length());
+
+  String utf8 = m.call("greeting_utf8");
+  ASSERT_EQUAL("UTF-8", utf8.call("encoding").call("name").to_s().str());
+  ASSERT_EQUAL(5, detail::From_Ruby<int>().convert(utf8.call("size")));
+
+  // The bytes are never transcoded
+  ASSERT_EQUAL(greeting(), binary.str());
+  ASSERT_EQUAL(greeting(), utf8.str());
+}
+
+namespace
+{
+  std::string status(int code)
+  {
+    return code == 0 ? "ok" : "failed";
+  }
+
+  const char* category(int code)
+  {
+    return code == 0 ? "success" : "error";
+  }
+}
+
+TESTCASE(std_string_return_interned)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("status", &status, Return().interned());
+  m.define_module_function("status_utf8", &status, Return().interned().utf8());
+  m.define_module_function("status_copy", &status);
+
+  Array result = m.module_eval("[status(0), status(0), status(1), status_utf8(0), status_copy(0)]");
+  Object first(result[0].value());
+
+  ASSERT(first.is_frozen());
+  ASSERT_EQUAL(first.value(), result[1].value());
+  ASSERT_EQUAL("failed", detail::From_Ruby<std::string>().convert(result[2].value()));
+  ASSERT_EQUAL("UTF-8", Object(result[3].value()).call("encoding").call("name").to_s().str());
+  ASSERT(!Object(result[4].value()).is_frozen());
+}
+
+TESTCASE(char_ptr_return_interned)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("category", &category, Return().interned());
+
+  Array result = m.module_eval("GC.start; [category(0), category(0), category(1), category(0)]");
+  ASSERT(Object(result[0].value()).is_frozen());
+  ASSERT_EQUAL(result[0].value(), result[1].value());
+  ASSERT_EQUAL(result[0].value(), result[3].value());
+  ASSERT_EQUAL("error", detail::From_Ruby<std::string>().convert(result[2].value()));
+  ASSERT_EQUAL("ASCII-8BIT", Object(result[0].value()).call("encoding").call("name").to_s().str());
+
+  // Same as the string Ruby interns for the literal
+  Object literal = m.module_eval("-'success'.b");
+  ASSERT_EQUAL(literal.value(), result[0].value());
+}
@@ -86,3 +86,60 @@ TESTCASE(std_string_view_from_ruby_refefence)
   string.instance_eval("self[1] = 'a'");
   //ASSERT_EQUAL("tast", view);
 }
+
+namespace
+{
+  const char* viewData = nullptr;
+
+  size_t borrow(const std::string_view& view)
+  {
+    viewData = view.data();
+    return view.size();
+  }
+
+  std::string inspectLocked(std::string_view view, Object callback)
+  {
+    callback.call("call");
+    return std::string(view);
+  }
+}
+
+TESTCASE(std_string_view_borrows_ruby_buffer)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("borrow", &borrow);
+
+  String string(std::string(1024 * 1024, 'x'));
+  Object result = m.call("borrow", string);
+  ASSERT_EQUAL(1024u * 1024u, detail::From_Ruby<size_t>().convert(result));
+  ASSERT_EQUAL((const void*)RSTRING_PTR(string.value()), (const void*)viewData);
+}
+
+TESTCASE(std_string_view_lock_string)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("inspect_locked", &inspectLocked, Arg("view").lockString(), Arg("callback"));
+
+  // The string cannot be modified while the native function is running, but can be afterwards
+  Array result = m.module_eval(R"(
+    string = +"payload"
+    error = nil
+    value = inspect_locked(string, -> { string << "!" rescue error = $! })
+    string << "!"
+    [value, error.class, string])");
+
+  ASSERT_EQUAL("payload", detail::From_Ruby<std::string>().convert(result[0].value()));
+  ASSERT_EQUAL(Object(rb_eRuntimeError), Object(result[1].value()));
+  ASSERT_EQUAL("payload!", detail::From_Ruby<std::string>().convert(result[2].value()));
+
+  // Exceptions unlock the string too
+  result = m.module_eval(R"(
+    string = +"payload"
+    begin
+      inspect_locked(string, -> { raise "failed" })
+    rescue
+    end
+    string << "!"
+    [string])");
+  ASSERT_EQUAL("payload!", detail::From_Ruby<std::string>().convert(result[0].value()));
+}
@@ -317,6 +317,78 @@ TESTCASE(ClassRoundtrip)
   ASSERT_EQUAL("Hi from MyClass2", detail::From_Ruby<std::string>().convert(hello));
 }
 
+namespace
+{
+  using Wide_Variant_T = std::variant<
+    std::monostate,
+    MyClass1,
+    MyClass2,
+    std::complex<double>,
+    std::vector<int>,
+    std::string,
+    double,
+    bool,
+    int,
+    MyClass
+  >;
+
+  size_t wideVariantIndex(Wide_Variant_T variant)
+  {
+    return variant.index();
+  }
+}
+
+TESTCASE(WideVariant)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("wide_variant_index", &wideVariantIndex);
+
+  // Run twice so the second pass uses the cached dispatch table
+  for (int i = 0; i < 2; i++)
+  {
+    ASSERT_EQUAL(1, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(MyClass1.new)")));
+    ASSERT_EQUAL(2, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(MyClass2.new)")));
+    ASSERT_EQUAL(3, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(Complex(1, 2))")));
+    ASSERT_EQUAL(4, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index([1, 2])")));
+    ASSERT_EQUAL(5, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index('a string')")));
+    ASSERT_EQUAL(6, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(1.5)")));
+    ASSERT_EQUAL(7, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(true)")));
+    ASSERT_EQUAL(7, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(false)")));
+    ASSERT_EQUAL(8, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(3)")));
+    ASSERT_EQUAL(9, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(MyClass.new)")));
+  }
+}
+
+TESTCASE(WideVariantSubclass)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("wide_variant_index", &wideVariantIndex);
+
+  std::string code = R"(class MyClass2Subclass < MyClass2
+                        end
+                        wide_variant_index(MyClass2Subclass.new))";
+  ASSERT_EQUAL(2, detail::From_Ruby<size_t>().convert(m.module_eval(code)));
+  ASSERT_EQUAL(2, detail::From_Ruby<size_t>().convert(m.module_eval("wide_variant_index(MyClass2Subclass.new)")));
+}
+
+TESTCASE(WideVariantNoMatch)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("wide_variant_index", &wideVariantIndex);
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    m.module_eval("wide_variant_index(:symbol)"),
+    ASSERT_EQUAL("Could not find converter for variant", ex.what())
+  );
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    m.module_eval("wide_variant_index(Object.new)"),
+    ASSERT_EQUAL("Could not find converter for variant", ex.what())
+  );
+}
+
 /* This test case runs successfully on MSVC but not g++. Having stepped through the code with
   GDB, this sure seems due to a bug with g++. The issue is this variable in created operator():
 
@@ -511,6 +511,31 @@ TESTCASE(DefaultValue)
   ASSERT_EQUAL(expected[2], actual[2]);
 }
 
+namespace
+{
+  const std::vector<std::string>* lastDefault = nullptr;
+
+  size_t defaultVectorRef(const std::vector<std::string>& strings)
+  {
+    lastDefault = &strings;
+    return strings.size();
+  }
+}
+
+TESTCASE(DefaultValueReference)
+{
+  define_global_function("default_vector_ref", &defaultVectorRef, Arg("strings") = std::vector<std::string> { "one", "two" });
+
+  // The default is passed by reference, so every call sees the same vector instead of a copy
+  Module m = define_module("Testing");
+  Object result = m.module_eval("default_vector_ref");
+  ASSERT_EQUAL(2, detail::From_Ruby<size_t>().convert(result));
+  const std::vector<std::string>* first = lastDefault;
+
+  m.module_eval("default_vector_ref");
+  ASSERT_EQUAL(first, lastDefault);
+}
+
 TESTCASE(ToArray)
 {
   Module m = define_module("Testing");
@@ -869,3 +894,98 @@ TESTCASE(MyClass2PointerVector)
  MyClass2* pMyClass = (*result)[0];
  ASSERT_EQUAL("Hello MyClass2", pMyClass->name);
 }
+
+
+namespace
+{
+  std::vector<std::string> myClass2Names(std::vector<MyClass2> values, std::vector<MyClass2*> pointers)
+  {
+    std::vector<std::string> result;
+    for (const MyClass2& value : values)
+    {
+      result.push_back(value.name);
+    }
+
+    for (MyClass2* pointer : pointers)
+    {
+      result.push_back(pointer ? pointer->name : "nil");
+    }
+    return result;
+  }
+}
+
+TESTCASE(ArrayToVectorWrapped)
+{
+  define_class<MyClass2>("MyClass2").
+    define_constructor(Constructor<MyClass2, std::string>());
+
+  define_global_function("my_class2_names", &myClass2Names);
+
+  Module m = define_module("Testing");
+
+  std::string code = R"(one = MyClass2.new("one")
+                        two = MyClass2.new("two")
+                        my_class2_names([one, two], [two, nil, one]).to_a)";
+
+  Array result = m.module_eval(code);
+  ASSERT_EQUAL(5, result.size());
+  ASSERT_EQUAL("one", detail::From_Ruby<std::string>().convert(result[0].value()));
+  ASSERT_EQUAL("two", detail::From_Ruby<std::string>().convert(result[1].value()));
+  ASSERT_EQUAL("two", detail::From_Ruby<std::string>().convert(result[2].value()));
+  ASSERT_EQUAL("nil", detail::From_Ruby<std::string>().convert(result[3].value()));
+  ASSERT_EQUAL("one", detail::From_Ruby<std::string>().convert(result[4].value()));
+
+  code = R"(my_class2_names([MyClass2.new("one"), "two"], []))";
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    m.module_eval(code),
+    ASSERT_EQUAL("Wrong argument type. Expected: MyClass2. Received: String.", ex.what())
+  );
+}
+
+TESTCASE(Memsize)
+{
+  define_vector<std::vector<double>>("DoubleVector");
+  define_vector<std::vector<std::string>>("StringVector");
+
+  Module m = define_module("Testing");
+  m.module_eval("require 'objspace'");
+
+  std::string code = R"(vec = DoubleVector.new
+                        vec.reserve(1_000_000)
+                        ObjectSpace.memsize_of(vec))";
+  size_t size = detail::From_Ruby<size_t>().convert(m.module_eval(code));
+  ASSERT((size >= 1'000'000 * sizeof(double)));
+
+  // The strings' buffers are included
+  code = R"(vec = StringVector.new
+            10.times { vec.push("a" * 1000) }
+            ObjectSpace.memsize_of(vec))";
+  size = detail::From_Ruby<size_t>().convert(m.module_eval(code));
+  ASSERT((size >= 10 * 1000));
+}
+
+namespace
+{
+  struct Packed
+  {
+    char data[64];
+  };
+}
+
+namespace Rice
+{
+  // Reports less than sizeof(Packed), for example because only part of it is in use
+  template<>
+  size_t ruby_memsize(const Packed* packed)
+  {
+    return 1;
+  }
+}
+
+TESTCASE(MemsizeSmallerThanType)
+{
+  std::vector<Packed> packed(10);
+  ASSERT_EQUAL(packed.capacity() * sizeof(Packed), detail::HeapSize<std::vector<Packed>>::size(packed));
+}
@@ -2,6 +2,8 @@
 #include "embed_ruby.hpp"
 #include <rice/rice.hpp>
 
+#include <cstring>
+
 using namespace Rice;
 
 TESTSUITE(String);
@@ -117,6 +119,24 @@ namespace {
   }
 }
 
+TESTCASE(buffer)
+{
+  String s = String::buffer(64);
+  ASSERT_EQUAL(0u, s.length());
+
+  char* data = s.data();
+  std::memcpy(data, "written in place", 16);
+  s.set_length(16);
+  ASSERT_EQUAL("written in place", s.str());
+  ASSERT_EQUAL("ASCII-8BIT", s.call("encoding").call("name").to_s().str());
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    s.set_length(1024 * 1024),
+    ASSERT_EQUAL(Object(rb_eArgError), Object(CLASS_OF(ex.value())))
+  );
+}
+
 TESTCASE(use_string_in_wrapped_function) {
   define_global_function("test_string_arg", &testStringArg);
 }
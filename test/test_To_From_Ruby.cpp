@@ -4,6 +4,9 @@
 
 #include <limits>
 #include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 using namespace Rice;
 
@@ -318,6 +321,55 @@ TESTCASE(double_from_ruby)
   );
 }
 
+TESTCASE(integer_fast_path_boundaries)
+{
+  // Negative fixnums are not converted inline for unsigned types, so they wrap like rb_num2ulong
+  ASSERT_EQUAL(std::numeric_limits<unsigned long>::max(), detail::From_Ruby<unsigned long>().convert(INT2FIX(-1)));
+  ASSERT_EQUAL(std::numeric_limits<unsigned int>::max(), detail::From_Ruby<unsigned int>().convert(INT2FIX(-1)));
+
+  // Fixnums that do not fit in a short are still range checked
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    detail::From_Ruby<short>().convert(INT2FIX(100000)),
+    ASSERT_EQUAL(Object(rb_eRangeError), Object(CLASS_OF(ex.value())))
+  );
+
+  // One past the fixnum range becomes a bignum
+  VALUE bignum = detail::to_ruby((long long)FIXNUM_MAX + 1);
+  ASSERT_EQUAL(RUBY_T_BIGNUM, rb_type(bignum));
+  ASSERT_EQUAL((long long)FIXNUM_MAX + 1, detail::From_Ruby<long long>().convert(bignum));
+  ASSERT_EQUAL(RUBY_T_FIXNUM, rb_type(detail::to_ruby((unsigned long long)FIXNUM_MAX)));
+  ASSERT_EQUAL(RUBY_T_BIGNUM, rb_type(detail::to_ruby((unsigned long long)FIXNUM_MAX + 1)));
+  ASSERT_EQUAL(RUBY_T_FIXNUM, rb_type(detail::to_ruby((long)FIXNUM_MIN)));
+  ASSERT_EQUAL(RUBY_T_BIGNUM, rb_type(detail::to_ruby((long)FIXNUM_MIN - 1)));
+}
+
+TESTCASE(float_fast_path_boundaries)
+{
+  // Integers are converted to doubles without coercion
+  ASSERT_EQUAL(3.0, detail::From_Ruby<double>().convert(INT2FIX(3)));
+  ASSERT_EQUAL(-3.0f, detail::From_Ruby<float>().convert(INT2FIX(-3)));
+  ASSERT_EQUAL(std::pow(2.0, 70), detail::From_Ruby<double>().convert(rb_eval_string("2 ** 70")));
+
+  // Doubles with a magnitude from 2^-255 up to 2^257 (except 2^-255 itself) and 0.0 are
+  // flonums, which are encoded in the VALUE itself. All other doubles, including -0.0, are
+  // allocated on the heap. Both kinds must round trip.
+  std::vector<std::pair<double, bool>> values{
+    { 0.0, true }, { -0.0, false }, { 0.1, true }, { -2.5, true },
+    { std::ldexp(1.0, -255), false }, { std::ldexp(1.0, -254), true }, { 1.72723e-77, false }, { 1e-300, false },
+    { std::ldexp(1.0, 256), true }, { std::ldexp(1.0, 257), false }, { 1e300, false }, { -1e300, false },
+    { std::numeric_limits<double>::infinity(), false } };
+
+  for (auto [value, flonum] : values)
+  {
+    VALUE converted = detail::to_ruby(value);
+    ASSERT_EQUAL(RUBY_T_FLOAT, rb_type(converted));
+    ASSERT_EQUAL(USE_FLONUM && flonum, (bool)FLONUM_P(converted));
+    ASSERT_EQUAL(value, detail::From_Ruby<double>().convert(converted));
+    ASSERT_EQUAL(std::signbit(value), std::signbit(detail::From_Ruby<double>().convert(converted)));
+  }
+}
+
 TESTCASE(char_const_ptr_to_ruby)
 {
   ASSERT(rb_equal(String("").value(), detail::to_ruby((char const *)"")));
@@ -330,6 +382,53 @@ TESTCASE(char_const_array_to_ruby_symbol)
   ASSERT(rb_equal(Symbol("foo").value(), detail::to_ruby(":foo")));
 }
 
+namespace
+{
+  char symbolBuffer[8] = ":ok";
+
+  char* returnSymbol()
+  {
+    return symbolBuffer;
+  }
+}
+
+TESTCASE(char_ptr_to_ruby_symbol_cached)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("return_symbol", &returnSymbol);
+
+  ASSERT_EQUAL(Symbol("ok").value(), m.call("return_symbol").value());
+  ASSERT_EQUAL(Symbol("ok").value(), m.call("return_symbol").value());
+
+  // Same address, different contents
+  std::strcpy(symbolBuffer, ":error");
+  ASSERT_EQUAL(Symbol("error").value(), m.call("return_symbol").value());
+
+  std::strcpy(symbolBuffer, ":ok");
+  ASSERT_EQUAL(Symbol("ok").value(), m.call("return_symbol").value());
+}
+
+TESTCASE(char_ptr_to_ruby_dynamic_symbol)
+{
+  Module m = define_module("Testing");
+  m.define_module_function("return_symbol", &returnSymbol);
+
+  // Symbols created from strings are dynamic
+  Object dynamic = m.module_eval("('dyn' + 'sym').to_sym");
+
+  std::strcpy(symbolBuffer, ":dynsym");
+  ASSERT_EQUAL(dynamic.value(), m.call("return_symbol").value());
+  ASSERT_EQUAL(dynamic.value(), m.call("return_symbol").value());
+
+  std::strcpy(symbolBuffer, ":ok");
+}
+
+TESTCASE(char_array_to_ruby_symbol_shorter_than_array)
+{
+  char symbol[16] = ":foo";
+  ASSERT_EQUAL(Symbol("foo").value(), detail::To_Ruby<char[16]>().convert(symbol));
+}
+
 TESTCASE(char_const_ptr_from_ruby)
 {
   char const* foo = "foo";
@@ -87,6 +87,7 @@ SETUP(Tracking)
 TEARDOWN(Tracking)
 {
   detail::Registries::instance.instances.isEnabled = true;
+  detail::Registries::instance.instances.untrack(Data_Type<MyClass>::ruby_data_type());
 }
 
 TESTCASE(TransferPointer)
@@ -237,3 +238,54 @@ TESTCASE(RubyObjectGced)
   String className = my_class2.class_name();
   ASSERT_EQUAL(std::string("MyClass"), className.str());
 }
+
+TESTCASE(TrackType)
+{
+  detail::Registries::instance.instances.isEnabled = false;
+  detail::Registries::instance.instances.track(Data_Type<MyClass>::ruby_data_type());
+  Factory::reset();
+
+  Module m = define_module("TestingModule");
+
+  Object factory = m.module_eval("Factory.new");
+
+  Data_Object<MyClass> my_class1 = factory.call("keep_pointer");
+  Data_Object<MyClass> my_class2 = factory.call("keep_pointer");
+  ASSERT(my_class1.is_equal(my_class2));
+
+  ASSERT(detail::Registries::instance.instances.isTracked(Data_Type<MyClass>::ruby_data_type()));
+  ASSERT(!detail::Registries::instance.instances.isTracked(Data_Type<Factory>::ruby_data_type()));
+
+  detail::Registries::instance.instances.untrack(Data_Type<MyClass>::ruby_data_type());
+  ASSERT(!detail::Registries::instance.instances.isTracked(Data_Type<MyClass>::ruby_data_type()));
+}
+
+TESTCASE(ManyInstances)
+{
+  // Use a local registry and stand in Fixnums for the Ruby instances, so nothing is
+  // wrapped or added to the global registry
+  detail::InstanceRegistry registry;
+  registry.isEnabled = true;
+
+  std::vector<MyClass> cppInstances(10000);
+  for (size_t i = 0; i < cppInstances.size(); i++)
+  {
+    registry.add(&cppInstances[i], INT2FIX(i));
+  }
+
+  // Remove every other instance so removals have to shift entries
+  for (size_t i = 0; i < cppInstances.size(); i += 2)
+  {
+    registry.remove(&cppInstances[i]);
+  }
+
+  rb_data_type_t* rbType = Data_Type<MyClass>::ruby_data_type();
+  for (size_t i = 0; i < cppInstances.size(); i++)
+  {
+    VALUE expected = (i % 2 == 0) ? Qnil : INT2FIX(i);
+    ASSERT_EQUAL(expected, registry.lookup(&cppInstances[i], rbType));
+  }
+
+  registry.clear();
+  ASSERT_EQUAL(Qnil, registry.lookup(&cppInstances[1], rbType));
+}
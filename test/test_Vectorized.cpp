@@ -0,0 +1,163 @@
+#include "unittest.hpp"
+#include "embed_ruby.hpp"
+#include <rice/rice.hpp>
+#include <rice/stl.hpp>
+
+using namespace Rice;
+
+TESTSUITE(Vectorized);
+
+SETUP(Vectorized)
+{
+  embed_ruby();
+}
+
+namespace
+{
+  struct Item
+  {
+    Item(int value = 0) : value(value)
+    {
+    }
+
+    int value;
+  };
+
+  class Model
+  {
+  public:
+    double score(const Item& item)
+    {
+      return item.value * this->weight;
+    }
+
+    double weight = 0.5;
+  };
+
+  int square(int value)
+  {
+    return value * value;
+  }
+
+  std::string label(const Item& item)
+  {
+    return "item " + std::to_string(item.value);
+  }
+
+  // Removes the last element of $shrinking, which is the collection being vectorized over
+  int popAndSquare(int value)
+  {
+    rb_funcall(rb_gv_get("$shrinking"), rb_intern("pop"), 0);
+    return value * value;
+  }
+}
+
+TESTCASE(vectorized_function)
+{
+  Module m(anonymous_module());
+  m.define_vectorized_function("square", &square);
+
+  Array result = m.instance_eval("o = Object.new; o.extend(self); o.square([1, 2, 3])");
+  ASSERT_EQUAL(3, result.size());
+  ASSERT_EQUAL(1, detail::From_Ruby<int>().convert(result[0].value()));
+  ASSERT_EQUAL(4, detail::From_Ruby<int>().convert(result[1].value()));
+  ASSERT_EQUAL(9, detail::From_Ruby<int>().convert(result[2].value()));
+
+  result = m.instance_eval("o = Object.new; o.extend(self); o.square([])");
+  ASSERT_EQUAL(0, result.size());
+}
+
+TESTCASE(vectorized_method)
+{
+  define_class<Item>("Item")
+    .define_constructor(Constructor<Item, int>());
+
+  Data_Type<Model> c = define_class<Model>("Model")
+    .define_constructor(Constructor<Model>())
+    .define_vectorized_method("scores", &Model::score)
+    .define_vectorized_function("labels", &label);
+
+  Array result = c.instance_eval("Model.new.scores([Item.new(2), Item.new(5)])");
+  ASSERT_EQUAL(2, result.size());
+  ASSERT_EQUAL(1.0, detail::From_Ruby<double>().convert(result[0].value()));
+  ASSERT_EQUAL(2.5, detail::From_Ruby<double>().convert(result[1].value()));
+
+  result = c.instance_eval("Model.new.labels([Item.new(7)])");
+  ASSERT_EQUAL("item 7", detail::From_Ruby<std::string>().convert(result[0].value()));
+}
+
+TESTCASE(vectorized_lambda)
+{
+  Data_Type<Model> c = define_class<Model>("Model")
+    .define_constructor(Constructor<Model>())
+    .define_vectorized_method("weighted", [](Model& self, int value)
+    {
+      return value * self.weight;
+    });
+
+  Array result = c.instance_eval("Model.new.weighted([4, 6])");
+  ASSERT_EQUAL(2.0, detail::From_Ruby<double>().convert(result[0].value()));
+  ASSERT_EQUAL(3.0, detail::From_Ruby<double>().convert(result[1].value()));
+}
+
+TESTCASE(wrapped_vector)
+{
+  define_class<Item>("Item")
+    .define_constructor(Constructor<Item, int>());
+
+  define_vector<std::vector<Item>>("ItemVector");
+
+  Module m(anonymous_module());
+  m.define_vectorized_function("labels", &label);
+
+  std::vector<Item> items{ Item(1), Item(2) };
+  Object vector = detail::To_Ruby<std::vector<Item>>().convert(items);
+
+  Object o = m.instance_eval("o = Object.new; o.extend(self); o");
+  Array result = o.call("labels", vector);
+  ASSERT_EQUAL(2, result.size());
+  ASSERT_EQUAL("item 1", detail::From_Ruby<std::string>().convert(result[0].value()));
+  ASSERT_EQUAL("item 2", detail::From_Ruby<std::string>().convert(result[1].value()));
+}
+
+TESTCASE(modified_array)
+{
+  Module m(anonymous_module());
+  m.define_vectorized_function("pop_and_square", &popAndSquare);
+
+  Array result = m.instance_eval("o = Object.new; o.extend(self); $shrinking = [1, 2, 3, 4]; o.pop_and_square($shrinking)");
+  ASSERT_EQUAL(2, result.size());
+  ASSERT_EQUAL(1, detail::From_Ruby<int>().convert(result[0].value()));
+  ASSERT_EQUAL(4, detail::From_Ruby<int>().convert(result[1].value()));
+}
+
+TESTCASE(modified_vector)
+{
+  define_vector<std::vector<int>>("IntVector");
+
+  Module m(anonymous_module());
+  m.define_vectorized_function("pop_and_square", &popAndSquare);
+
+  Array result = m.instance_eval("o = Object.new; o.extend(self); $shrinking = IntVector.new; [1, 2, 3, 4].each { |i| $shrinking.push(i) }; o.pop_and_square($shrinking)");
+  ASSERT_EQUAL(2, result.size());
+  ASSERT_EQUAL(1, detail::From_Ruby<int>().convert(result[0].value()));
+  ASSERT_EQUAL(4, detail::From_Ruby<int>().convert(result[1].value()));
+}
+
+TESTCASE(invalid_argument)
+{
+  Module m(anonymous_module());
+  m.define_vectorized_function("square", &square);
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    m.instance_eval("o = Object.new; o.extend(self); o.square(3)"),
+    ASSERT_EQUAL(Object(rb_eTypeError), Object(CLASS_OF(ex.value())))
+  );
+
+  ASSERT_EXCEPTION_CHECK(
+    Exception,
+    m.instance_eval("o = Object.new; o.extend(self); o.square(['a'])"),
+    ASSERT_EQUAL(Object(rb_eTypeError), Object(CLASS_OF(ex.value())))
+  );
+}